@@ -29,10 +29,18 @@ public class NeatMetadata : ModuleRules
 				"DeveloperSettings",
 				"UnrealEd",
 				"PropertyEditor",
-				"ClassViewer",
 				"InputCore",
 				"BlueprintGraph",
+				"AssetRegistry",
+				"Json",
+				"WorkspaceMenuStructure",
+				"ToolMenus",
 			}
 		);
+
+		if (Target.bWithLiveCoding)
+		{
+			PrivateDependencyModuleNames.Add("LiveCoding");
+		}
 	}
 }
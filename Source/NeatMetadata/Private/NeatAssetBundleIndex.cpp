@@ -0,0 +1,426 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#include "NeatAssetBundleIndex.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/AssetBundleData.h"
+#include "Algo/BinarySearch.h"
+#include "Editor.h"
+#include "Engine/Blueprint.h"
+#include "Engine/DataAsset.h"
+#include "Kismet2/KismetEditorUtilities.h"
+#include "Misc/PackageName.h"
+#include "String/ParseTokens.h"
+#include "UObject/UObjectHash.h"
+
+namespace
+{
+	const FName AssetBundlesName("AssetBundles");
+
+	// Time spent on the index each tick while it is being rebuilt.
+	constexpr double BuildBudgetSeconds = 0.002;
+}
+
+TUniquePtr<FNeatAssetBundleIndex> FNeatAssetBundleIndex::Instance;
+
+FNeatAssetBundleIndex& FNeatAssetBundleIndex::Get()
+{
+	if (!Instance)
+	{
+		Instance = TUniquePtr<FNeatAssetBundleIndex>(new FNeatAssetBundleIndex());
+	}
+	return *Instance;
+}
+
+void FNeatAssetBundleIndex::TearDown()
+{
+	Instance.Reset();
+}
+
+FNeatAssetBundleIndex::FNeatAssetBundleIndex()
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(AssetRegistryConstants::ModuleName).Get();
+	AssetAddedHandle = AssetRegistry.OnAssetAdded().AddRaw(this, &FNeatAssetBundleIndex::OnAssetAddedOrUpdated);
+	AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddRaw(this, &FNeatAssetBundleIndex::OnAssetRemoved);
+	AssetUpdatedHandle = AssetRegistry.OnAssetUpdated().AddRaw(this, &FNeatAssetBundleIndex::OnAssetAddedOrUpdated);
+	AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddRaw(this, &FNeatAssetBundleIndex::OnAssetRenamed);
+	FilesLoadedHandle = AssetRegistry.OnFilesLoaded().AddRaw(this, &FNeatAssetBundleIndex::StartBuild);
+
+	AssetLoadedHandle = FCoreUObjectDelegates::OnAssetLoaded.AddRaw(this, &FNeatAssetBundleIndex::OnAssetLoaded);
+	ModulesChangedHandle = FModuleManager::Get().OnModulesChanged().AddRaw(this, &FNeatAssetBundleIndex::OnModulesChanged);
+
+	if (GEditor)
+	{
+		BlueprintPreCompileHandle = GEditor->OnBlueprintPreCompile().AddRaw(this, &FNeatAssetBundleIndex::OnBlueprintPreCompile);
+		BlueprintCompiledHandle = GEditor->OnBlueprintCompiled().AddRaw(this, &FNeatAssetBundleIndex::OnBlueprintCompiled);
+	}
+}
+
+FNeatAssetBundleIndex::~FNeatAssetBundleIndex()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	}
+
+	if (FModuleManager* ModuleManager = FModuleManager::GetModuleManagerIfExists())
+	{
+		ModuleManager->OnModulesChanged().Remove(ModulesChangedHandle);
+	}
+	if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>(AssetRegistryConstants::ModuleName))
+	{
+		AssetRegistryModule->Get().OnAssetAdded().Remove(AssetAddedHandle);
+		AssetRegistryModule->Get().OnAssetRemoved().Remove(AssetRemovedHandle);
+		AssetRegistryModule->Get().OnAssetUpdated().Remove(AssetUpdatedHandle);
+		AssetRegistryModule->Get().OnAssetRenamed().Remove(AssetRenamedHandle);
+		AssetRegistryModule->Get().OnFilesLoaded().Remove(FilesLoadedHandle);
+	}
+	FCoreUObjectDelegates::OnAssetLoaded.Remove(AssetLoadedHandle);
+
+	if (GEditor)
+	{
+		GEditor->OnBlueprintPreCompile().Remove(BlueprintPreCompileHandle);
+		GEditor->OnBlueprintCompiled().Remove(BlueprintCompiledHandle);
+	}
+}
+
+TConstArrayView<FNeatAssetBundleIndex::FEntry> FNeatAssetBundleIndex::GetEntries()
+{
+	if (!bHasBuilt && !IsBuilding())
+	{
+		StartBuild();
+	}
+
+	if (bEntriesDirty && !IsBuilding())
+	{
+		bEntriesDirty = false;
+		Entries.Reset(Counts.Num());
+		Counts.GenerateValueArray(Entries);
+		Entries.Sort([](const FEntry& A, const FEntry& B) { return A.Name.LexicalLess(B.Name); });
+	}
+	return Entries;
+}
+
+const FNeatAssetBundleIndex::FEntry* FNeatAssetBundleIndex::FindEntry(FName InName)
+{
+	const TConstArrayView<FEntry> AllEntries = GetEntries();
+	const int32 Index = Algo::LowerBound(AllEntries, InName, [](const FEntry& Entry, FName Name) { return Entry.Name.LexicalLess(Name); });
+	return AllEntries.IsValidIndex(Index) && AllEntries[Index].Name == InName ? &AllEntries[Index] : nullptr;
+}
+
+void FNeatAssetBundleIndex::StartBuild()
+{
+	// Anything that has been gathered so far may be out of date, so a build that is in progress starts over.
+	ClassBundles.Reset();
+	AssetBundles.Reset();
+	Counts.Reset();
+	ChangedClasses.Reset();
+	ChangedAssets.Reset();
+	NextClass = 0;
+	NextAsset = 0;
+
+	TArray<UClass*> DerivedClasses;
+	GetDerivedClasses(UPrimaryDataAsset::StaticClass(), DerivedClasses, true);
+	PendingClasses.Reset(DerivedClasses.Num() + 1);
+	PendingClasses.Add(UPrimaryDataAsset::StaticClass());
+	PendingClasses.Append(DerivedClasses);
+
+	// Gathering the asset data is cheap compared to reading the bundles of each asset.
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(AssetRegistryConstants::ModuleName).Get();
+	FARFilter Filter;
+	Filter.ClassPaths.Add(UPrimaryDataAsset::StaticClass()->GetClassPathName());
+	Filter.bRecursiveClasses = true;
+	PendingAssets.Reset();
+	AssetRegistry.GetAssets(Filter, PendingAssets);
+
+	if (!TickerHandle.IsValid())
+	{
+		TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FNeatAssetBundleIndex::TickBuild));
+	}
+}
+
+bool FNeatAssetBundleIndex::TickBuild(float DeltaTime)
+{
+	const double EndTime = FPlatformTime::Seconds() + BuildBudgetSeconds;
+
+	while (NextClass < PendingClasses.Num())
+	{
+		const UClass* Class = PendingClasses[NextClass++].Get();
+		if (Class && IsRelevantClass(Class) && !ChangedClasses.Contains(Class->GetClassPathName()))
+		{
+			UpdateClass(Class->GetClassPathName(), Class);
+		}
+
+		if (FPlatformTime::Seconds() > EndTime)
+		{
+			return true;
+		}
+	}
+
+	while (NextAsset < PendingAssets.Num())
+	{
+		const FAssetData& AssetData = PendingAssets[NextAsset++];
+		const FSoftObjectPath AssetPath = AssetData.GetSoftObjectPath();
+		if (!ChangedAssets.Contains(AssetPath))
+		{
+			UpdateAsset(AssetPath, &AssetData);
+		}
+
+		if (FPlatformTime::Seconds() > EndTime)
+		{
+			return true;
+		}
+	}
+
+	FinishBuild();
+	return false;
+}
+
+void FNeatAssetBundleIndex::FinishBuild()
+{
+	TickerHandle.Reset();
+	bHasBuilt = true;
+	bEntriesDirty = true;
+	Generation++;
+
+	PendingClasses.Empty();
+	PendingAssets.Empty();
+	ChangedClasses.Empty();
+	ChangedAssets.Empty();
+}
+
+void FNeatAssetBundleIndex::UpdateClass(const FTopLevelAssetPath& InClassPath, const UClass* InClass)
+{
+	TArray<FName> Bundles;
+	if (InClass && IsRelevantClass(InClass))
+	{
+		// Only look at properties declared by this class, inherited ones are counted when their own class is visited.
+		for (TFieldIterator<const FProperty> It(InClass, EFieldIteratorFlags::ExcludeSuper); It; ++It)
+		{
+			if (const FString* PropertyBundles = It->FindMetaData(AssetBundlesName))
+			{
+				UE::String::ParseTokens(*PropertyBundles, TEXT(','), [&](FStringView Bundle)
+				{
+					Bundles.Emplace(Bundle);
+				}, UE::String::EParseTokensOptions::SkipEmpty | UE::String::EParseTokensOptions::Trim);
+			}
+		}
+	}
+
+	if (const TArray<FName>* Previous = ClassBundles.Find(InClassPath))
+	{
+		UpdateCounts(*Previous, &FEntry::NumProperties, -1);
+	}
+	UpdateCounts(Bundles, &FEntry::NumProperties, 1);
+
+	if (Bundles.IsEmpty())
+	{
+		ClassBundles.Remove(InClassPath);
+	}
+	else
+	{
+		ClassBundles.Add(InClassPath, MoveTemp(Bundles));
+	}
+
+	if (IsBuilding())
+	{
+		ChangedClasses.Add(InClassPath);
+	}
+}
+
+void FNeatAssetBundleIndex::UpdateAsset(const FSoftObjectPath& InAssetPath, const FAssetData* InAssetData)
+{
+	// An asset may have several entries for the same bundle, but should only be counted once per bundle.
+	TArray<FName> Bundles;
+	if (InAssetData && InAssetData->TaggedAssetBundles.IsValid())
+	{
+		for (const FAssetBundleEntry& BundleEntry : InAssetData->TaggedAssetBundles->Bundles)
+		{
+			if (!BundleEntry.BundleName.IsNone())
+			{
+				Bundles.AddUnique(BundleEntry.BundleName);
+			}
+		}
+	}
+
+	if (const TArray<FName>* Previous = AssetBundles.Find(InAssetPath))
+	{
+		UpdateCounts(*Previous, &FEntry::NumAssets, -1);
+	}
+	UpdateCounts(Bundles, &FEntry::NumAssets, 1);
+
+	if (Bundles.IsEmpty())
+	{
+		AssetBundles.Remove(InAssetPath);
+	}
+	else
+	{
+		AssetBundles.Add(InAssetPath, MoveTemp(Bundles));
+	}
+
+	if (IsBuilding())
+	{
+		ChangedAssets.Add(InAssetPath);
+	}
+}
+
+void FNeatAssetBundleIndex::UpdateCounts(TConstArrayView<FName> InBundles, int32 FEntry::* InCount, int32 InDelta)
+{
+	if (InBundles.IsEmpty())
+	{
+		return;
+	}
+
+	for (const FName Bundle : InBundles)
+	{
+		FEntry& Entry = Counts.FindOrAdd(Bundle);
+		Entry.Name = Bundle;
+		Entry.*InCount += InDelta;
+		if (Entry.NumProperties <= 0 && Entry.NumAssets <= 0)
+		{
+			Counts.Remove(Bundle);
+		}
+	}
+
+	// While building, the generation changes once the build has finished.
+	bEntriesDirty = true;
+	if (!IsBuilding())
+	{
+		Generation++;
+	}
+}
+
+bool FNeatAssetBundleIndex::IsRelevantClass(const UClass* InClass)
+{
+	if (!InClass || InClass->HasAnyClassFlags(CLASS_NewerVersionExists) || !InClass->IsChildOf<UPrimaryDataAsset>())
+	{
+		return false;
+	}
+
+	// Skeleton classes have the same properties as their generated class, don't count them twice.
+	return !FKismetEditorUtilities::IsClassABlueprintSkeleton(InClass);
+}
+
+bool FNeatAssetBundleIndex::IsRelevantBlueprint(const FAssetData& InAssetData)
+{
+	// The native parent is always in memory, so this works without loading the Blueprint.
+	FString NativeParentClassPath;
+	if (!InAssetData.GetTagValue(FBlueprintTags::NativeParentClassPath, NativeParentClassPath))
+	{
+		return false;
+	}
+
+	const UClass* NativeParentClass = FSoftClassPath(FPackageName::ExportTextPathToObjectPath(NativeParentClassPath)).ResolveClass();
+	return NativeParentClass && NativeParentClass->IsChildOf<UPrimaryDataAsset>();
+}
+
+FTopLevelAssetPath FNeatAssetBundleIndex::GetGeneratedClassPath(FName InPackageName, FName InAssetName)
+{
+	return FTopLevelAssetPath(InPackageName, FName(InAssetName.ToString() + TEXT("_C")));
+}
+
+bool FNeatAssetBundleIndex::CanUpdate() const
+{
+	// Changes are ignored until the index is first built, and while the asset registry is still discovering assets, since
+	// it is rebuilt once that has finished.
+	return (bHasBuilt || IsBuilding()) && !FModuleManager::LoadModuleChecked<FAssetRegistryModule>(AssetRegistryConstants::ModuleName).Get().IsLoadingAssets();
+}
+
+void FNeatAssetBundleIndex::OnAssetAddedOrUpdated(const FAssetData& InAssetData)
+{
+	if (!CanUpdate())
+	{
+		return;
+	}
+
+	if (InAssetData.TaggedAssetBundles.IsValid() || AssetBundles.Contains(InAssetData.GetSoftObjectPath()))
+	{
+		UpdateAsset(InAssetData.GetSoftObjectPath(), &InAssetData);
+	}
+
+	// Only Blueprint classes that are in memory have variables to read. An update of one that isn't loaded doesn't change them.
+	if (IsRelevantBlueprint(InAssetData))
+	{
+		const FTopLevelAssetPath ClassPath = GetGeneratedClassPath(InAssetData.PackageName, InAssetData.AssetName);
+		if (const UClass* Class = FindObject<UClass>(nullptr, *ClassPath.ToString()))
+		{
+			UpdateClass(ClassPath, Class);
+		}
+	}
+}
+
+void FNeatAssetBundleIndex::OnAssetRemoved(const FAssetData& InAssetData)
+{
+	if (!CanUpdate())
+	{
+		return;
+	}
+
+	UpdateAsset(InAssetData.GetSoftObjectPath(), nullptr);
+	UpdateClass(GetGeneratedClassPath(InAssetData.PackageName, InAssetData.AssetName), nullptr);
+}
+
+void FNeatAssetBundleIndex::OnAssetRenamed(const FAssetData& InAssetData, const FString& InOldObjectPath)
+{
+	if (!CanUpdate())
+	{
+		return;
+	}
+
+	const FSoftObjectPath OldPath(InOldObjectPath);
+	UpdateAsset(OldPath, nullptr);
+	UpdateClass(GetGeneratedClassPath(OldPath.GetLongPackageFName(), FName(OldPath.GetAssetName())), nullptr);
+	OnAssetAddedOrUpdated(InAssetData);
+}
+
+void FNeatAssetBundleIndex::OnAssetLoaded(UObject* InObject)
+{
+	// Loading a Blueprint brings its variables, and their metadata, into memory.
+	const UBlueprint* Blueprint = Cast<UBlueprint>(InObject);
+	if (Blueprint && IsRelevantClass(Blueprint->GeneratedClass) && CanUpdate())
+	{
+		UpdateClass(Blueprint->GeneratedClass->GetClassPathName(), Blueprint->GeneratedClass);
+	}
+}
+
+void FNeatAssetBundleIndex::OnBlueprintPreCompile(UBlueprint* InBlueprint)
+{
+	if (InBlueprint && CanUpdate())
+	{
+		CompilingBlueprints.AddUnique(InBlueprint);
+	}
+}
+
+void FNeatAssetBundleIndex::OnBlueprintCompiled()
+{
+	// A Blueprint may have been reparented away from UPrimaryDataAsset, in which case its class no longer declares anything.
+	for (const TWeakObjectPtr<UBlueprint>& WeakBlueprint : CompilingBlueprints)
+	{
+		if (const UBlueprint* Blueprint = WeakBlueprint.Get())
+		{
+			UpdateClass(GetGeneratedClassPath(Blueprint->GetPackage()->GetFName(), Blueprint->GetFName()), Blueprint->GeneratedClass);
+		}
+	}
+	CompilingBlueprints.Reset();
+}
+
+void FNeatAssetBundleIndex::OnModulesChanged(FName ModuleName, EModuleChangeReason Reason)
+{
+	// Modules may add native primary data asset classes, which are all in the script package of the module.
+	if (Reason != EModuleChangeReason::ModuleLoaded || !CanUpdate())
+	{
+		return;
+	}
+
+	if (const UPackage* Package = FindPackage(nullptr, *(TEXT("/Script/") + ModuleName.ToString())))
+	{
+		ForEachObjectWithPackage(Package, [this](UObject* Object)
+		{
+			const UClass* Class = Cast<UClass>(Object);
+			if (Class && IsRelevantClass(Class))
+			{
+				UpdateClass(Class->GetClassPathName(), Class);
+			}
+			return true;
+		}, false);
+	}
+}
@@ -0,0 +1,123 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#pragma once
+#include "CoreMinimal.h"
+#include "Modules/ModuleManager.h"
+#include "Containers/Ticker.h"
+#include "AssetRegistry/AssetData.h"
+
+class UBlueprint;
+
+/**
+ * Index of all asset bundle names used by primary data assets, together with how often each of them is used.
+ *
+ * Bundle names are gathered from the AssetBundles metadata of properties in native and Blueprint primary data asset
+ * classes that are in memory, and from the bundle data that the asset registry stores for each primary data asset, so
+ * nothing is loaded. The index is built once in time slices on the core ticker, and the previous result stays available
+ * until that has finished. Afterwards, only the contribution of an asset or class that changes is updated.
+ */
+class FNeatAssetBundleIndex
+{
+public:
+	static FNeatAssetBundleIndex& Get();
+	static void TearDown();
+
+	~FNeatAssetBundleIndex();
+
+	struct FEntry
+	{
+		FName Name;
+		// Number of properties that declare the bundle.
+		int32 NumProperties = 0;
+		// Number of assets that have data in the bundle.
+		int32 NumAssets = 0;
+	};
+
+	/**
+	 * @brief All known bundle names, sorted by name. Starts building the index if it has never been built.
+	 */
+	TConstArrayView<FEntry> GetEntries();
+
+	/**
+	 * @brief Finds a bundle in the index.
+	 * @param InName The name of the bundle.
+	 * @return The entry, or nullptr if no primary data asset uses the bundle.
+	 */
+	const FEntry* FindEntry(FName InName);
+
+	// Changes whenever the entries change.
+	uint32 GetGeneration() const { return Generation; }
+
+	// Whether the index is currently being rebuilt.
+	bool IsBuilding() const { return TickerHandle.IsValid(); }
+
+private:
+	FNeatAssetBundleIndex();
+
+	void StartBuild();
+	bool TickBuild(float DeltaTime);
+	void FinishBuild();
+
+	/**
+	 * @brief Replaces the bundles declared by the properties of a class. Classes that aren't relevant declare nothing.
+	 * @param InClassPath The path of the class, which stays the same when a Blueprint class is reinstanced.
+	 * @param InClass The class, or nullptr if it has been removed.
+	 */
+	void UpdateClass(const FTopLevelAssetPath& InClassPath, const UClass* InClass);
+	/**
+	 * @brief Replaces the bundles that an asset has data in.
+	 * @param InAssetPath The path of the asset.
+	 * @param InAssetData The asset data, or nullptr if the asset has been removed.
+	 */
+	void UpdateAsset(const FSoftObjectPath& InAssetPath, const FAssetData* InAssetData);
+	void UpdateCounts(TConstArrayView<FName> InBundles, int32 FEntry::* InCount, int32 InDelta);
+
+	static bool IsRelevantClass(const UClass* InClass);
+	static bool IsRelevantBlueprint(const FAssetData& InAssetData);
+	static FTopLevelAssetPath GetGeneratedClassPath(FName InPackageName, FName InAssetName);
+
+	void OnAssetAddedOrUpdated(const FAssetData& InAssetData);
+	void OnAssetRemoved(const FAssetData& InAssetData);
+	void OnAssetRenamed(const FAssetData& InAssetData, const FString& InOldObjectPath);
+	void OnAssetLoaded(UObject* InObject);
+	void OnBlueprintPreCompile(UBlueprint* InBlueprint);
+	void OnBlueprintCompiled();
+	void OnModulesChanged(FName ModuleName, EModuleChangeReason Reason);
+	bool CanUpdate() const;
+
+	// Sorted copy of Counts, updated lazily. Not updated while building, so that the previous result stays available.
+	TArray<FEntry> Entries;
+	bool bEntriesDirty = false;
+	uint32 Generation = 0;
+	bool bHasBuilt = false;
+
+	// What each class and asset contributes to Counts, so that it can be taken back out when they change. A class has
+	// one name for each property that declares a bundle.
+	TMap<FTopLevelAssetPath, TArray<FName>> ClassBundles;
+	TMap<FSoftObjectPath, TArray<FName>> AssetBundles;
+	TMap<FName, FEntry> Counts;
+
+	// Blueprints that are being compiled. The compiled event doesn't say which Blueprints it was for.
+	TArray<TWeakObjectPtr<UBlueprint>> CompilingBlueprints;
+
+	// State of the build that is in progress.
+	TArray<TWeakObjectPtr<const UClass>> PendingClasses;
+	TArray<FAssetData> PendingAssets;
+	int32 NextClass = 0;
+	int32 NextAsset = 0;
+	// Classes and assets that changed while building. Their pending state is older, so it is skipped.
+	TSet<FTopLevelAssetPath> ChangedClasses;
+	TSet<FSoftObjectPath> ChangedAssets;
+	FTSTicker::FDelegateHandle TickerHandle;
+
+	FDelegateHandle AssetAddedHandle;
+	FDelegateHandle AssetRemovedHandle;
+	FDelegateHandle AssetRenamedHandle;
+	FDelegateHandle AssetUpdatedHandle;
+	FDelegateHandle FilesLoadedHandle;
+	FDelegateHandle AssetLoadedHandle;
+	FDelegateHandle BlueprintPreCompileHandle;
+	FDelegateHandle BlueprintCompiledHandle;
+	FDelegateHandle ModulesChangedHandle;
+
+	static TUniquePtr<FNeatAssetBundleIndex> Instance;
+};
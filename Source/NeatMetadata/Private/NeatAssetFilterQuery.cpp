@@ -0,0 +1,66 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#include "NeatAssetFilterQuery.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Algo/AllOf.h"
+#include "Algo/AnyOf.h"
+#include "Tasks/Task.h"
+
+TSharedRef<FNeatAssetFilterQuery, ESPMode::ThreadSafe> FNeatAssetFilterQuery::Launch(const FNeatAssetFilterQueryParams& InParams, int32 InNumSamples)
+{
+	check(IsInGameThread());
+	TSharedRef<FNeatAssetFilterQuery, ESPMode::ThreadSafe> Query = MakeShareable(new FNeatAssetFilterQuery());
+
+	if (InParams.AllowedClasses.IsEmpty())
+	{
+		Query->bDone = true;
+		return Query;
+	}
+
+	// Expanding class hierarchies needs the class data of the asset registry, so it has to be done before leaving the game thread.
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(AssetRegistryConstants::ModuleName).Get();
+	FARFilter Filter;
+	Filter.ClassPaths = InParams.AllowedClasses;
+	Filter.RecursiveClassPathsExclusionSet.Append(InParams.DisallowedClasses);
+	Filter.bRecursiveClasses = true;
+	Filter.bIncludeOnlyOnDiskAssets = true;
+
+	FARCompiledFilter CompiledFilter;
+	AssetRegistry.CompileFilter(Filter, CompiledFilter);
+
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [Query, Params = InParams, CompiledFilter = MoveTemp(CompiledFilter), InNumSamples]()
+	{
+		const IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+		AssetRegistry.EnumerateAssets(CompiledFilter, [&](const FAssetData& AssetData)
+		{
+			if (Query->IsCancelled())
+			{
+				return false;
+			}
+
+			if (MatchesTags(AssetData, Params))
+			{
+				if (Query->Result.Samples.Num() < InNumSamples)
+				{
+					Query->Result.Samples.Add(AssetData.GetSoftObjectPath());
+				}
+				Query->Result.NumAssets++;
+			}
+			return true;
+		});
+
+		Query->bDone = true;
+	});
+
+	return Query;
+}
+
+bool FNeatAssetFilterQuery::MatchesTags(const FAssetData& InAssetData, const FNeatAssetFilterQueryParams& InParams)
+{
+	auto HasTag = [&](const TPair<FName, FString>& InTag)
+	{
+		return InTag.Value.IsEmpty() ? InAssetData.TagsAndValues.Contains(InTag.Key) : InAssetData.TagsAndValues.ContainsKeyValue(InTag.Key, InTag.Value);
+	};
+
+	return Algo::AllOf(InParams.RequiredTags, HasTag) && !Algo::AnyOf(InParams.DisallowedTags, HasTag);
+}
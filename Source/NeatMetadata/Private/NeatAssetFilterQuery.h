@@ -0,0 +1,74 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#pragma once
+#include "CoreMinimal.h"
+#include "UObject/TopLevelAssetPath.h"
+#include <atomic>
+
+/**
+ * The parts of an asset picker filter that can be evaluated against the asset registry.
+ */
+struct FNeatAssetFilterQueryParams
+{
+	// Classes whose assets, including subclasses, are admitted. Nothing is admitted if this is empty.
+	TArray<FTopLevelAssetPath> AllowedClasses;
+	// Classes whose assets, including subclasses, are excluded.
+	TArray<FTopLevelAssetPath> DisallowedClasses;
+
+	// Tags that must all be present. An empty value matches any value.
+	TArray<TPair<FName, FString>> RequiredTags;
+	// Tags that must not be present. An empty value matches any value.
+	TArray<TPair<FName, FString>> DisallowedTags;
+
+	bool operator==(const FNeatAssetFilterQueryParams& Other) const
+	{
+		return AllowedClasses == Other.AllowedClasses && DisallowedClasses == Other.DisallowedClasses
+			&& RequiredTags == Other.RequiredTags && DisallowedTags == Other.DisallowedTags;
+	}
+	bool operator!=(const FNeatAssetFilterQueryParams& Other) const { return !(*this == Other); }
+};
+
+/**
+ * Counts the assets that a filter admits, on a background thread.
+ *
+ * The class part of the filter is compiled on the game thread when the query is launched. The asset registry is then
+ * enumerated on a worker thread, only looking at assets on disk, so nothing is ever loaded. The query checks for
+ * cancellation between assets.
+ */
+class FNeatAssetFilterQuery : public TSharedFromThis<FNeatAssetFilterQuery, ESPMode::ThreadSafe>
+{
+public:
+	struct FResult
+	{
+		int32 NumAssets = 0;
+		// The first few admitted assets, in the order the asset registry enumerated them.
+		TArray<FSoftObjectPath> Samples;
+	};
+
+	/**
+	 * @brief Starts a query. Must be called on the game thread.
+	 * @param InParams The filter to evaluate.
+	 * @param InNumSamples The maximum number of assets to return in the result.
+	 * @return The query, which is done once IsDone returns true.
+	 */
+	static TSharedRef<FNeatAssetFilterQuery, ESPMode::ThreadSafe> Launch(const FNeatAssetFilterQueryParams& InParams, int32 InNumSamples);
+
+	// Stops the query as soon as possible. The result of a cancelled query is incomplete.
+	void Cancel() { bCancelled = true; }
+	bool IsCancelled() const { return bCancelled; }
+
+	bool IsDone() const { return bDone; }
+
+	/**
+	 * @brief The result of the query. Only valid once the query is done.
+	 */
+	const FResult& GetResult() const { check(IsDone()); return Result; }
+
+private:
+	FNeatAssetFilterQuery() = default;
+
+	static bool MatchesTags(const struct FAssetData& InAssetData, const FNeatAssetFilterQueryParams& InParams);
+
+	FResult Result;
+	std::atomic<bool> bCancelled = false;
+	std::atomic<bool> bDone = false;
+};
@@ -0,0 +1,228 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#include "NeatFunctionIndex.h"
+
+#include "Editor.h"
+#include "Engine/Blueprint.h"
+#include "Kismet2/KismetEditorUtilities.h"
+#include "UObject/UObjectHash.h"
+
+#if WITH_LIVE_CODING
+#include "ILiveCodingModule.h"
+#endif
+
+TUniquePtr<FNeatFunctionIndex> FNeatFunctionIndex::Instance;
+
+FNeatFunctionIndex& FNeatFunctionIndex::Get()
+{
+	if (!Instance)
+	{
+		Instance = TUniquePtr<FNeatFunctionIndex>(new FNeatFunctionIndex());
+	}
+	return *Instance;
+}
+
+void FNeatFunctionIndex::TearDown()
+{
+	Instance.Reset();
+}
+
+FNeatFunctionIndex::FNeatFunctionIndex()
+{
+	ModulesChangedHandle = FModuleManager::Get().OnModulesChanged().AddRaw(this, &FNeatFunctionIndex::OnModulesChanged);
+	AssetLoadedHandle = FCoreUObjectDelegates::OnAssetLoaded.AddRaw(this, &FNeatFunctionIndex::OnAssetLoaded);
+	ReloadCompleteHandle = FCoreUObjectDelegates::ReloadCompleteDelegate.AddRaw(this, &FNeatFunctionIndex::OnReloadComplete);
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddRaw(this, &FNeatFunctionIndex::OnPostGarbageCollect);
+
+	if (GEditor)
+	{
+		BlueprintPreCompileHandle = GEditor->OnBlueprintPreCompile().AddRaw(this, &FNeatFunctionIndex::OnBlueprintPreCompile);
+		BlueprintCompiledHandle = GEditor->OnBlueprintCompiled().AddRaw(this, &FNeatFunctionIndex::OnBlueprintCompiled);
+	}
+
+#if WITH_LIVE_CODING
+	if (ILiveCodingModule* LiveCoding = FModuleManager::GetModulePtr<ILiveCodingModule>(LIVE_CODING_MODULE_NAME))
+	{
+		LiveCodingPatchCompleteHandle = LiveCoding->GetOnPatchCompleteDelegate().AddRaw(this, &FNeatFunctionIndex::MarkDirty);
+	}
+#endif
+}
+
+FNeatFunctionIndex::~FNeatFunctionIndex()
+{
+	if (FModuleManager* ModuleManager = FModuleManager::GetModuleManagerIfExists())
+	{
+		ModuleManager->OnModulesChanged().Remove(ModulesChangedHandle);
+	}
+	FCoreUObjectDelegates::OnAssetLoaded.Remove(AssetLoadedHandle);
+	FCoreUObjectDelegates::ReloadCompleteDelegate.Remove(ReloadCompleteHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+
+	if (GEditor)
+	{
+		GEditor->OnBlueprintPreCompile().Remove(BlueprintPreCompileHandle);
+		GEditor->OnBlueprintCompiled().Remove(BlueprintCompiledHandle);
+	}
+
+#if WITH_LIVE_CODING
+	if (ILiveCodingModule* LiveCoding = FModuleManager::GetModulePtr<ILiveCodingModule>(LIVE_CODING_MODULE_NAME))
+	{
+		LiveCoding->GetOnPatchCompleteDelegate().Remove(LiveCodingPatchCompleteHandle);
+	}
+#endif
+}
+
+void FNeatFunctionIndex::ForEachFunction(TFunctionRef<FForEachFunctionSignature> Functor)
+{
+	RebuildIfDirty();
+
+	for (const TPair<FObjectKey, FClassEntry>& Pair : Classes)
+	{
+		const UClass* Class = Pair.Value.Class.Get();
+		if (!IsIndexedClass(Class))
+		{
+			continue;
+		}
+
+		for (const TWeakObjectPtr<const UFunction>& WeakFunction : Pair.Value.Functions)
+		{
+			if (const UFunction* Function = WeakFunction.Get())
+			{
+				Functor(*Class, *Function);
+			}
+		}
+	}
+}
+
+bool FNeatFunctionIndex::IsIndexedClass(const UClass* InClass)
+{
+	if (!InClass || InClass->HasAnyClassFlags(CLASS_NewerVersionExists))
+	{
+		return false;
+	}
+
+	return !FKismetEditorUtilities::IsClassABlueprintSkeleton(InClass);
+}
+
+void FNeatFunctionIndex::RebuildIfDirty()
+{
+	if (!bDirty)
+	{
+		return;
+	}
+
+	bDirty = false;
+	Classes.Reset();
+
+	// Walking classes means functions are gathered per class, without a lookup for each function.
+	for (const UClass* Class : TObjectRange<UClass>())
+	{
+		IndexClass(*Class);
+	}
+}
+
+void FNeatFunctionIndex::IndexClass(const UClass& InClass)
+{
+	const FObjectKey Key(&InClass);
+	if (!IsIndexedClass(&InClass))
+	{
+		Classes.Remove(Key);
+		return;
+	}
+
+	TArray<TWeakObjectPtr<const UFunction>> Functions;
+	for (const UFunction* Function : TFieldRange<UFunction>(&InClass, EFieldIteratorFlags::ExcludeSuper))
+	{
+		if (Function->HasAnyFunctionFlags(FUNC_BlueprintCallable | FUNC_BlueprintPure))
+		{
+			Functions.Add(Function);
+		}
+	}
+
+	if (Functions.IsEmpty())
+	{
+		Classes.Remove(Key);
+		return;
+	}
+
+	FClassEntry& Entry = Classes.FindOrAdd(Key);
+	Entry.Class = &InClass;
+	Entry.Functions = MoveTemp(Functions);
+}
+
+void FNeatFunctionIndex::OnModulesChanged(FName ModuleName, EModuleChangeReason Reason)
+{
+	if (bDirty || Reason != EModuleChangeReason::ModuleLoaded)
+	{
+		return;
+	}
+
+	// Only look at the classes that were added by the module that was loaded.
+	const UPackage* ScriptPackage = FindPackage(nullptr, *FString::Printf(TEXT("/Script/%s"), *ModuleName.ToString()));
+	if (!ScriptPackage)
+	{
+		return;
+	}
+
+	ForEachObjectWithPackage(ScriptPackage, [this](UObject* Object)
+	{
+		if (const UClass* AsClass = Cast<UClass>(Object))
+		{
+			IndexClass(*AsClass);
+		}
+		return true;
+	}, false);
+}
+
+void FNeatFunctionIndex::OnAssetLoaded(UObject* InObject)
+{
+	const UBlueprint* AsBlueprint = Cast<UBlueprint>(InObject);
+	if (!bDirty && AsBlueprint && AsBlueprint->GeneratedClass)
+	{
+		IndexClass(*AsBlueprint->GeneratedClass);
+	}
+}
+
+void FNeatFunctionIndex::OnBlueprintPreCompile(UBlueprint* InBlueprint)
+{
+	CompilingBlueprints.AddUnique(InBlueprint);
+}
+
+void FNeatFunctionIndex::OnBlueprintCompiled()
+{
+	// Compiling regenerates the functions of the generated class, and may create the generated class in the first place.
+	TArray<TWeakObjectPtr<UBlueprint>> CompiledBlueprints = MoveTemp(CompilingBlueprints);
+	if (bDirty)
+	{
+		return;
+	}
+
+	for (const TWeakObjectPtr<UBlueprint>& WeakBlueprint : CompiledBlueprints)
+	{
+		const UBlueprint* Blueprint = WeakBlueprint.Get();
+		if (Blueprint && Blueprint->GeneratedClass)
+		{
+			IndexClass(*Blueprint->GeneratedClass);
+		}
+	}
+}
+
+void FNeatFunctionIndex::OnReloadComplete(EReloadCompleteReason Reason)
+{
+	MarkDirty();
+}
+
+void FNeatFunctionIndex::OnPostGarbageCollect()
+{
+	for (auto It = Classes.CreateIterator(); It; ++It)
+	{
+		if (!It->Value.Class.IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void FNeatFunctionIndex::MarkDirty()
+{
+	bDirty = true;
+}
@@ -0,0 +1,73 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#pragma once
+#include "CoreMinimal.h"
+#include "Modules/ModuleManager.h"
+#include "UObject/ObjectKey.h"
+
+class UBlueprint;
+enum class EReloadCompleteReason;
+
+/**
+ * Persistent index of all Blueprint callable functions that are in memory, grouped by the class they are declared in.
+ *
+ * The index is built once, and is then updated per class when modules are loaded and Blueprints are loaded or compiled.
+ * Hot reload and Live Coding may touch any class, so they cause a full rebuild the next time the index is used.
+ */
+class FNeatFunctionIndex
+{
+public:
+	static FNeatFunctionIndex& Get();
+	static void TearDown();
+
+	~FNeatFunctionIndex();
+
+	using FForEachFunctionSignature = void(const UClass&, const UFunction&);
+	/**
+	 * @brief Loops through all indexed functions. Functions declared in the same class are visited consecutively.
+	 * @param Functor Functor that executes for each function, together with the class that declares it.
+	 */
+	void ForEachFunction(TFunctionRef<FForEachFunctionSignature> Functor);
+
+	/**
+	 * @brief Should functions declared in the input class be part of the index?
+	 * @param InClass The class to test.
+	 * @return False for skeleton classes, and classes that have been replaced by a newer version.
+	 */
+	static bool IsIndexedClass(const UClass* InClass);
+
+private:
+	FNeatFunctionIndex();
+
+	struct FClassEntry
+	{
+		TWeakObjectPtr<const UClass> Class;
+		TArray<TWeakObjectPtr<const UFunction>> Functions;
+	};
+
+	void RebuildIfDirty();
+	void IndexClass(const UClass& InClass);
+
+	void OnModulesChanged(FName ModuleName, EModuleChangeReason Reason);
+	void OnAssetLoaded(UObject* InObject);
+	void OnBlueprintPreCompile(UBlueprint* InBlueprint);
+	void OnBlueprintCompiled();
+	void OnReloadComplete(EReloadCompleteReason Reason);
+	void OnPostGarbageCollect();
+	void MarkDirty();
+
+	TMap<FObjectKey, FClassEntry> Classes;
+	TArray<TWeakObjectPtr<UBlueprint>> CompilingBlueprints;
+	bool bDirty = true;
+
+	FDelegateHandle ModulesChangedHandle;
+	FDelegateHandle AssetLoadedHandle;
+	FDelegateHandle BlueprintPreCompileHandle;
+	FDelegateHandle BlueprintCompiledHandle;
+	FDelegateHandle ReloadCompleteHandle;
+	FDelegateHandle PostGarbageCollectHandle;
+#if WITH_LIVE_CODING
+	FDelegateHandle LiveCodingPatchCompleteHandle;
+#endif
+
+	static TUniquePtr<FNeatFunctionIndex> Instance;
+};
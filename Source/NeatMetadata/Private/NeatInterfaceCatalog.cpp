@@ -0,0 +1,247 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#include "NeatInterfaceCatalog.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/Blueprint.h"
+#include "Kismet2/KismetEditorUtilities.h"
+#include "UObject/Interface.h"
+#include "UObject/UObjectHash.h"
+
+TUniquePtr<FNeatInterfaceCatalog> FNeatInterfaceCatalog::Instance;
+
+FNeatInterfaceCatalog& FNeatInterfaceCatalog::Get()
+{
+	if (!Instance)
+	{
+		Instance = TUniquePtr<FNeatInterfaceCatalog>(new FNeatInterfaceCatalog());
+	}
+	return *Instance;
+}
+
+void FNeatInterfaceCatalog::TearDown()
+{
+	Instance.Reset();
+}
+
+FNeatInterfaceCatalog::FNeatInterfaceCatalog()
+{
+	// Interfaces all derive from UInterface, so this doesn't touch unrelated classes.
+	TArray<UClass*> DerivedClasses;
+	GetDerivedClasses(UInterface::StaticClass(), DerivedClasses, true);
+	for (const UClass* Class : DerivedClasses)
+	{
+		AddLoadedClass(Class);
+	}
+
+	ModulesChangedHandle = FModuleManager::Get().OnModulesChanged().AddRaw(this, &FNeatInterfaceCatalog::OnModulesChanged);
+	AssetLoadedHandle = FCoreUObjectDelegates::OnAssetLoaded.AddRaw(this, &FNeatInterfaceCatalog::OnAssetLoaded);
+	ReloadAddedClassesHandle = FCoreUObjectDelegates::ReloadAddedClassesDelegate.AddRaw(this, &FNeatInterfaceCatalog::OnReloadAddedClasses);
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(AssetRegistryConstants::ModuleName).Get();
+	if (AssetRegistry.IsLoadingAssets())
+	{
+		FilesLoadedHandle = AssetRegistry.OnFilesLoaded().AddRaw(this, &FNeatInterfaceCatalog::DiscoverBlueprintInterfaces);
+	}
+	else
+	{
+		DiscoverBlueprintInterfaces();
+	}
+}
+
+FNeatInterfaceCatalog::~FNeatInterfaceCatalog()
+{
+	if (FModuleManager* ModuleManager = FModuleManager::GetModuleManagerIfExists())
+	{
+		ModuleManager->OnModulesChanged().Remove(ModulesChangedHandle);
+	}
+	if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>(AssetRegistryConstants::ModuleName))
+	{
+		AssetRegistryModule->Get().OnFilesLoaded().Remove(FilesLoadedHandle);
+		AssetRegistryModule->Get().OnAssetAdded().Remove(AssetAddedHandle);
+		AssetRegistryModule->Get().OnAssetRemoved().Remove(AssetRemovedHandle);
+		AssetRegistryModule->Get().OnAssetRenamed().Remove(AssetRenamedHandle);
+	}
+	FCoreUObjectDelegates::OnAssetLoaded.Remove(AssetLoadedHandle);
+	FCoreUObjectDelegates::ReloadAddedClassesDelegate.Remove(ReloadAddedClassesHandle);
+}
+
+void FNeatInterfaceCatalog::ForEachEntry(TFunctionRef<FForEachEntrySignature> Functor) const
+{
+	for (const TPair<FTopLevelAssetPath, FEntry>& Pair : Entries)
+	{
+		Functor(Pair.Value);
+	}
+}
+
+UClass* FNeatInterfaceCatalog::LoadInterfaceClass(const FTopLevelAssetPath& InClassPath)
+{
+	if (InClassPath.IsNull())
+	{
+		return nullptr;
+	}
+
+	UClass* Class = FindObject<UClass>(InClassPath);
+	if (!Class)
+	{
+		Class = LoadObject<UClass>(nullptr, *InClassPath.ToString());
+	}
+	return IsInterfaceClass(Class) ? Class : nullptr;
+}
+
+bool FNeatInterfaceCatalog::IsInterfaceClass(const UClass* InClass)
+{
+	if (!InClass || InClass == UInterface::StaticClass() || !InClass->HasAnyClassFlags(CLASS_Interface))
+	{
+		return false;
+	}
+
+	if (InClass->HasAnyClassFlags(CLASS_NewerVersionExists))
+	{
+		return false;
+	}
+
+	return !FKismetEditorUtilities::IsClassABlueprintSkeleton(InClass);
+}
+
+bool FNeatInterfaceCatalog::IsBlueprintInterface(const FAssetData& InAssetData)
+{
+	static const FString InterfaceType = StaticEnum<EBlueprintType>()->GetNameStringByValue(BPTYPE_Interface);
+	return InAssetData.GetTagValueRef<FString>(FBlueprintTags::BlueprintType) == InterfaceType;
+}
+
+FTopLevelAssetPath FNeatInterfaceCatalog::GetGeneratedClassPath(const FAssetData& InAssetData)
+{
+	const FString GeneratedClassPath = InAssetData.GetTagValueRef<FString>(FBlueprintTags::GeneratedClassPath);
+	return GeneratedClassPath.IsEmpty() ? FTopLevelAssetPath() : FTopLevelAssetPath(FPackageName::ExportTextPathToObjectPath(GeneratedClassPath));
+}
+
+void FNeatInterfaceCatalog::AddLoadedClass(const UClass* InClass)
+{
+	if (!IsInterfaceClass(InClass))
+	{
+		return;
+	}
+
+	const FTopLevelAssetPath ClassPath = InClass->GetClassPathName();
+	FEntry& Entry = Entries.FindOrAdd(ClassPath);
+	if (Entry.ClassPath.IsNull())
+	{
+		Entry.ClassPath = ClassPath;
+		Generation++;
+	}
+	
+	// Loaded classes know their real display name, which may differ from the one guessed from the asset name.
+	Entry.DisplayName = InClass->GetDisplayNameText();
+}
+
+void FNeatInterfaceCatalog::AddBlueprintInterface(const FAssetData& InAssetData)
+{
+	if (!IsBlueprintInterface(InAssetData))
+	{
+		return;
+	}
+
+	const FTopLevelAssetPath ClassPath = GetGeneratedClassPath(InAssetData);
+	if (ClassPath.IsNull() || Entries.Contains(ClassPath))
+	{
+		return;
+	}
+
+	FEntry& Entry = Entries.Add(ClassPath);
+	Entry.ClassPath = ClassPath;
+	Entry.DisplayName = FText::FromString(FName::NameToDisplayString(InAssetData.AssetName.ToString(), false));
+	Generation++;
+}
+
+void FNeatInterfaceCatalog::RemoveEntry(const FTopLevelAssetPath& InClassPath)
+{
+	if (Entries.Remove(InClassPath) > 0)
+	{
+		Generation++;
+	}
+}
+
+void FNeatInterfaceCatalog::DiscoverBlueprintInterfaces()
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(AssetRegistryConstants::ModuleName).Get();
+	AssetRegistry.OnFilesLoaded().Remove(FilesLoadedHandle);
+
+	// Only the blueprint type tag is needed to tell interfaces apart, nothing has to be loaded.
+	FARFilter Filter;
+	Filter.ClassPaths.Add(UBlueprint::StaticClass()->GetClassPathName());
+	Filter.bRecursiveClasses = true;
+	Filter.TagsAndValues.Add(FBlueprintTags::BlueprintType, StaticEnum<EBlueprintType>()->GetNameStringByValue(BPTYPE_Interface));
+	
+	AssetRegistry.EnumerateAssets(Filter, [this](const FAssetData& AssetData)
+	{
+		AddBlueprintInterface(AssetData);
+		return true;
+	});
+
+	AssetAddedHandle = AssetRegistry.OnAssetAdded().AddRaw(this, &FNeatInterfaceCatalog::OnAssetAdded);
+	AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddRaw(this, &FNeatInterfaceCatalog::OnAssetRemoved);
+	AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddRaw(this, &FNeatInterfaceCatalog::OnAssetRenamed);
+}
+
+void FNeatInterfaceCatalog::OnAssetAdded(const FAssetData& InAssetData)
+{
+	AddBlueprintInterface(InAssetData);
+}
+
+void FNeatInterfaceCatalog::OnAssetRemoved(const FAssetData& InAssetData)
+{
+	if (IsBlueprintInterface(InAssetData))
+	{
+		RemoveEntry(GetGeneratedClassPath(InAssetData));
+	}
+}
+
+void FNeatInterfaceCatalog::OnAssetRenamed(const FAssetData& InAssetData, const FString& InOldObjectPath)
+{
+	if (!IsBlueprintInterface(InAssetData))
+	{
+		return;
+	}
+
+	// The generated class is named after the Blueprint, and lives in the same package.
+	const FSoftObjectPath OldBlueprintPath(InOldObjectPath);
+	RemoveEntry(FTopLevelAssetPath(OldBlueprintPath.GetLongPackageFName(), *(OldBlueprintPath.GetAssetName() + TEXT("_C"))));
+	AddBlueprintInterface(InAssetData);
+}
+
+void FNeatInterfaceCatalog::OnAssetLoaded(UObject* InObject)
+{
+	if (const UBlueprint* AsBlueprint = Cast<UBlueprint>(InObject))
+	{
+		AddLoadedClass(AsBlueprint->GeneratedClass);
+	}
+}
+
+void FNeatInterfaceCatalog::OnModulesChanged(FName ModuleName, EModuleChangeReason Reason)
+{
+	if (Reason != EModuleChangeReason::ModuleLoaded)
+	{
+		return;
+	}
+
+	// Only look at the classes that were added by the module that was loaded.
+	const UPackage* ScriptPackage = FindPackage(nullptr, *FString::Printf(TEXT("/Script/%s"), *ModuleName.ToString()));
+	if (!ScriptPackage)
+	{
+		return;
+	}
+
+	ForEachObjectWithPackage(ScriptPackage, [this](UObject* Object)
+	{
+		AddLoadedClass(Cast<UClass>(Object));
+		return true;
+	}, false);
+}
+
+void FNeatInterfaceCatalog::OnReloadAddedClasses(const TArray<UClass*>& InClasses)
+{
+	for (const UClass* Class : InClasses)
+	{
+		AddLoadedClass(Class);
+	}
+}
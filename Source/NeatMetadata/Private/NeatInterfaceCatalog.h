@@ -0,0 +1,78 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#pragma once
+#include "CoreMinimal.h"
+#include "Modules/ModuleManager.h"
+#include "UObject/TopLevelAssetPath.h"
+
+struct FAssetData;
+
+/**
+ * Persistent catalog of all interfaces, including Blueprint interfaces that haven't been loaded yet.
+ *
+ * Loaded interfaces are found through the class hash, and unloaded Blueprint interfaces through their asset registry
+ * tags. The catalog is then kept up to date incrementally as modules are loaded, and as Blueprint interfaces are added,
+ * removed, renamed or loaded.
+ */
+class FNeatInterfaceCatalog
+{
+public:
+	static FNeatInterfaceCatalog& Get();
+	static void TearDown();
+
+	~FNeatInterfaceCatalog();
+
+	struct FEntry
+	{
+		FTopLevelAssetPath ClassPath;
+		FText DisplayName;
+	};
+
+	using FForEachEntrySignature = void(const FEntry&);
+	/**
+	 * @brief Loops through all interfaces in the catalog, in no particular order.
+	 * @param Functor Functor that executes for each interface.
+	 */
+	void ForEachEntry(TFunctionRef<FForEachEntrySignature> Functor) const;
+
+	// Changes whenever interfaces are added to, or removed from, the catalog.
+	uint32 GetGeneration() const { return Generation; }
+
+	/**
+	 * @brief Finds or loads the class of an interface in the catalog.
+	 * @param InClassPath The path of the interface class.
+	 * @return The class, or nullptr if it couldn't be loaded.
+	 */
+	static UClass* LoadInterfaceClass(const FTopLevelAssetPath& InClassPath);
+
+private:
+	FNeatInterfaceCatalog();
+
+	static bool IsInterfaceClass(const UClass* InClass);
+	static bool IsBlueprintInterface(const FAssetData& InAssetData);
+	static FTopLevelAssetPath GetGeneratedClassPath(const FAssetData& InAssetData);
+
+	void AddLoadedClass(const UClass* InClass);
+	void AddBlueprintInterface(const FAssetData& InAssetData);
+	void RemoveEntry(const FTopLevelAssetPath& InClassPath);
+
+	void DiscoverBlueprintInterfaces();
+	void OnAssetAdded(const FAssetData& InAssetData);
+	void OnAssetRemoved(const FAssetData& InAssetData);
+	void OnAssetRenamed(const FAssetData& InAssetData, const FString& InOldObjectPath);
+	void OnAssetLoaded(UObject* InObject);
+	void OnModulesChanged(FName ModuleName, EModuleChangeReason Reason);
+	void OnReloadAddedClasses(const TArray<UClass*>& InClasses);
+
+	TMap<FTopLevelAssetPath, FEntry> Entries;
+	uint32 Generation = 0;
+
+	FDelegateHandle FilesLoadedHandle;
+	FDelegateHandle AssetAddedHandle;
+	FDelegateHandle AssetRemovedHandle;
+	FDelegateHandle AssetRenamedHandle;
+	FDelegateHandle AssetLoadedHandle;
+	FDelegateHandle ModulesChangedHandle;
+	FDelegateHandle ReloadAddedClassesHandle;
+
+	static TUniquePtr<FNeatInterfaceCatalog> Instance;
+};
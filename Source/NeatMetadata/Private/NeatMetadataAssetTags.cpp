@@ -0,0 +1,274 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#include "NeatMetadataAssetTags.h"
+#include "NeatMetadataCollectionLayout.h"
+#include "NeatMetadataCollectionRegistry.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/Blueprint.h"
+
+const FName FNeatMetadataAssetTags::TagName(TEXT("NeatMetadata"));
+FDelegateHandle FNeatMetadataAssetTags::ExtraObjectTagsHandle;
+
+namespace
+{
+	// Bumped whenever the encoding changes, so that values written by older versions can be told apart. Version 1 didn't
+	// have variable types, and only listed variables with managed metadata.
+	constexpr TCHAR FormatVersion[] = TEXT("2");
+	constexpr TCHAR FormatVersionWithoutTypes[] = TEXT("1");
+
+	// Variables are separated by '|', a variable name and its type are each followed by ':', keys and values are separated
+	// by '=' and key-value pairs by ';'. Any of those, and the escape character itself, are escaped with a backslash.
+	constexpr TCHAR EscapeChar = TEXT('\\');
+	constexpr TCHAR VariableDelimiter = TEXT('|');
+	constexpr TCHAR NameDelimiter = TEXT(':');
+	constexpr TCHAR PairDelimiter = TEXT(';');
+	constexpr TCHAR ValueDelimiter = TEXT('=');
+
+	void AppendEscaped(FString& Out, FStringView InString)
+	{
+		for (const TCHAR Char : InString)
+		{
+			if (Char == EscapeChar || Char == VariableDelimiter || Char == NameDelimiter || Char == PairDelimiter || Char == ValueDelimiter)
+			{
+				Out.AppendChar(EscapeChar);
+			}
+			Out.AppendChar(Char);
+		}
+	}
+
+	FString Unescape(FStringView InString)
+	{
+		FString Result;
+		Result.Reserve(InString.Len());
+		for (int32 Index = 0; Index < InString.Len(); Index++)
+		{
+			if (InString[Index] == EscapeChar && Index + 1 < InString.Len())
+			{
+				Index++;
+			}
+			Result.AppendChar(InString[Index]);
+		}
+		return Result;
+	}
+
+	// Finds the first delimiter that isn't escaped.
+	int32 FindUnescaped(FStringView InString, TCHAR InDelimiter)
+	{
+		for (int32 Index = 0; Index < InString.Len(); Index++)
+		{
+			if (InString[Index] == EscapeChar)
+			{
+				Index++;
+			}
+			else if (InString[Index] == InDelimiter)
+			{
+				return Index;
+			}
+		}
+		return INDEX_NONE;
+	}
+
+	// Splits on a delimiter that isn't escaped. The parts are left escaped, so that they can be split further.
+	void SplitUnescaped(FStringView InString, TCHAR InDelimiter, TArray<FStringView>& OutParts)
+	{
+		while (!InString.IsEmpty())
+		{
+			const int32 Index = FindUnescaped(InString, InDelimiter);
+			if (Index == INDEX_NONE)
+			{
+				OutParts.Add(InString);
+				break;
+			}
+			OutParts.Add(InString.Left(Index));
+			InString.RightChopInline(Index + 1);
+		}
+	}
+
+	void OnGetExtraObjectTags(const UObject* InObject, TArray<UObject::FAssetRegistryTag>& InOutTags)
+	{
+		const UBlueprint* Blueprint = Cast<UBlueprint>(InObject);
+		if (!Blueprint)
+		{
+			return;
+		}
+
+		// The tag is written even without variables, so that a missing tag means that the Blueprint was saved before the
+		// plugin was enabled, and has to be loaded to be searched.
+		TArray<FNeatMetadataVariableSummary> Variables;
+		FNeatMetadataAssetTags::Summarize(*Blueprint, Variables);
+		InOutTags.Emplace(FNeatMetadataAssetTags::TagName, FNeatMetadataAssetTags::Encode(Variables), UObject::FAssetRegistryTag::TT_Hidden);
+	}
+}
+
+void FNeatMetadataAssetTags::Register()
+{
+	if (!ExtraObjectTagsHandle.IsValid())
+	{
+		ExtraObjectTagsHandle = UObject::FAssetRegistryTag::OnGetExtraObjectTags.AddStatic(&OnGetExtraObjectTags);
+	}
+}
+
+void FNeatMetadataAssetTags::Unregister()
+{
+	UObject::FAssetRegistryTag::OnGetExtraObjectTags.Remove(ExtraObjectTagsHandle);
+	ExtraObjectTagsHandle.Reset();
+}
+
+void FNeatMetadataAssetTags::Summarize(const UBlueprint& InBlueprint, TArray<FNeatMetadataVariableSummary>& OutVariables)
+{
+	for (const FBPVariableDescription& Variable : InBlueprint.NewVariables)
+	{
+		FNeatMetadataVariableSummary& Summary = OutVariables.AddDefaulted_GetRef();
+		Summary.Variable = Variable.VarName;
+		Summary.Type = GetTypeString(Variable.VarType);
+		for (const FBPVariableMetaDataEntry& Entry : Variable.MetaDataArray)
+		{
+			if (IsManagedKey(Entry.DataKey))
+			{
+				Summary.Metadata.Emplace(Entry.DataKey, Entry.DataValue);
+			}
+		}
+	}
+}
+
+FString FNeatMetadataAssetTags::Encode(TConstArrayView<FNeatMetadataVariableSummary> InVariables)
+{
+	FString Result = FormatVersion;
+	for (const FNeatMetadataVariableSummary& Variable : InVariables)
+	{
+		Result.AppendChar(VariableDelimiter);
+		AppendEscaped(Result, Variable.Variable.ToString());
+		Result.AppendChar(NameDelimiter);
+		AppendEscaped(Result, Variable.Type);
+		Result.AppendChar(NameDelimiter);
+		for (int32 Index = 0; Index < Variable.Metadata.Num(); Index++)
+		{
+			if (Index > 0)
+			{
+				Result.AppendChar(PairDelimiter);
+			}
+			AppendEscaped(Result, Variable.Metadata[Index].Key.ToString());
+			Result.AppendChar(ValueDelimiter);
+			AppendEscaped(Result, Variable.Metadata[Index].Value);
+		}
+	}
+	return Result;
+}
+
+bool FNeatMetadataAssetTags::Decode(FStringView InValue, TArray<FNeatMetadataVariableSummary>& OutVariables)
+{
+	TArray<FStringView> Variables;
+	SplitUnescaped(InValue, VariableDelimiter, Variables);
+	if (Variables.IsEmpty() || (Variables[0] != FormatVersion && Variables[0] != FormatVersionWithoutTypes))
+	{
+		return false;
+	}
+	const bool bHasTypes = Variables[0] == FormatVersion;
+
+	TArray<FStringView> Pairs;
+	for (int32 VariableIndex = 1; VariableIndex < Variables.Num(); VariableIndex++)
+	{
+		const FStringView Variable = Variables[VariableIndex];
+		const int32 NameEnd = FindUnescaped(Variable, NameDelimiter);
+		if (NameEnd == INDEX_NONE)
+		{
+			return false;
+		}
+
+		FNeatMetadataVariableSummary& Summary = OutVariables.AddDefaulted_GetRef();
+		Summary.Variable = FName(Unescape(Variable.Left(NameEnd)));
+
+		FStringView Rest = Variable.RightChop(NameEnd + 1);
+		if (bHasTypes)
+		{
+			const int32 TypeEnd = FindUnescaped(Rest, NameDelimiter);
+			if (TypeEnd == INDEX_NONE)
+			{
+				return false;
+			}
+			Summary.Type = Unescape(Rest.Left(TypeEnd));
+			Rest.RightChopInline(TypeEnd + 1);
+		}
+
+		Pairs.Reset();
+		SplitUnescaped(Rest, PairDelimiter, Pairs);
+		for (const FStringView Pair : Pairs)
+		{
+			const int32 KeyEnd = FindUnescaped(Pair, ValueDelimiter);
+			if (KeyEnd == INDEX_NONE)
+			{
+				return false;
+			}
+			Summary.Metadata.Emplace(FName(Unescape(Pair.Left(KeyEnd))), Unescape(Pair.RightChop(KeyEnd + 1)));
+		}
+	}
+	return true;
+}
+
+bool FNeatMetadataAssetTags::GetSummary(const FAssetData& InAssetData, TArray<FNeatMetadataVariableSummary>& OutVariables)
+{
+	const FAssetTagValueRef Value = InAssetData.TagsAndValues.FindTag(TagName);
+	return Value.IsSet() && Decode(Value.AsString(), OutVariables);
+}
+
+bool FNeatMetadataAssetTags::IsTagged(const FAssetData& InAssetData)
+{
+	return InAssetData.TagsAndValues.Contains(TagName);
+}
+
+void FNeatMetadataAssetTags::ForEachVariable(TFunctionRef<FForEachVariableSignature> Functor)
+{
+	FARFilter Filter;
+	Filter.TagsAndValues.Add(TagName);
+
+	const IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(AssetRegistryConstants::ModuleName).Get();
+	TArray<FNeatMetadataVariableSummary> Variables;
+	AssetRegistry.EnumerateAssets(Filter, [&](const FAssetData& AssetData)
+	{
+		Variables.Reset();
+		if (GetSummary(AssetData, Variables))
+		{
+			for (const FNeatMetadataVariableSummary& Variable : Variables)
+			{
+				Functor(AssetData, Variable);
+			}
+		}
+		return true;
+	});
+}
+
+bool FNeatMetadataAssetTags::IsManagedKey(FName InKey)
+{
+	// Some collections store a property under a different key, e.g. RequiredAssetDataTags_Internal is written as
+	// RequiredAssetDataTags. Only existing names are looked up, so that unrelated keys don't add to the name table.
+	const FName InternalKey(*(InKey.ToString() + TEXT("_Internal")), FNAME_Find);
+
+	bool bIsManaged = false;
+	FNeatMetadataCollectionRegistry::Get().ForEachClass([&](UClass& Class)
+	{
+		const FNeatMetadataCollectionLayout& Layout = FNeatMetadataCollectionLayout::Get(Class);
+		bIsManaged = bIsManaged || Layout.FindIndex(InKey) != INDEX_NONE || Layout.FindIndex(InternalKey) != INDEX_NONE;
+	});
+	return bIsManaged;
+}
+
+FString FNeatMetadataAssetTags::GetTypeString(const FEdGraphPinType& InType)
+{
+	auto GetTerminalString = [](FName InCategory, const UObject* InSubCategoryObject)
+	{
+		return InSubCategoryObject ? FString::Printf(TEXT("%s(%s)"), *InCategory.ToString(), *InSubCategoryObject->GetName()) : InCategory.ToString();
+	};
+
+	const FString Terminal = GetTerminalString(InType.PinCategory, InType.PinSubCategoryObject.Get());
+	switch (InType.ContainerType)
+	{
+	case EPinContainerType::Array:
+		return FString::Printf(TEXT("Array<%s>"), *Terminal);
+	case EPinContainerType::Set:
+		return FString::Printf(TEXT("Set<%s>"), *Terminal);
+	case EPinContainerType::Map:
+		return FString::Printf(TEXT("Map<%s, %s>"), *Terminal, *GetTerminalString(InType.PinValueType.TerminalCategory, InType.PinValueType.TerminalSubCategoryObject.Get()));
+	default:
+		return Terminal;
+	}
+}
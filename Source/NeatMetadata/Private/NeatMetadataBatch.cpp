@@ -0,0 +1,117 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#include "NeatMetadataBatch.h"
+#include "NeatMetadataChange.h"
+#include "NeatMetadataVariableIndex.h"
+#include "Engine/Blueprint.h"
+#include "Misc/ITransaction.h"
+
+FNeatMetadataBatch* FNeatMetadataBatch::Outermost = nullptr;
+
+FNeatMetadataBatch::FNeatMetadataBatch()
+{
+	check(IsInGameThread());
+
+	if (!Outermost)
+	{
+		Outermost = this;
+		bIsOutermost = true;
+	}
+}
+
+FNeatMetadataBatch::~FNeatMetadataBatch()
+{
+	if (bIsOutermost)
+	{
+		// Clear first, so that anything that reacts to the flush isn't batched into a batch that is going away.
+		Outermost = nullptr;
+		Flush();
+	}
+}
+
+void FNeatMetadataBatch::SetMetadata(UBlueprint* InBlueprint, FName InVarName, FName Key, const FString& Value)
+{
+	GetOutermost().PendingWrites.FindOrAdd(InBlueprint).FindOrAdd(InVarName).Add(Key, Value);
+}
+
+void FNeatMetadataBatch::RemoveMetadata(UBlueprint* InBlueprint, FName InVarName, FName Key)
+{
+	GetOutermost().PendingWrites.FindOrAdd(InBlueprint).FindOrAdd(InVarName).Add(Key, NullOpt);
+}
+
+const TOptional<FString>* FNeatMetadataBatch::FindPending(UBlueprint* InBlueprint, FName InVarName, FName Key)
+{
+	if (!Outermost)
+	{
+		return nullptr;
+	}
+
+	const FVariableWrites* VariableWrites = Outermost->PendingWrites.Find(InBlueprint);
+	const FKeyWrites* KeyWrites = VariableWrites ? VariableWrites->Find(InVarName) : nullptr;
+	return KeyWrites ? KeyWrites->Find(Key) : nullptr;
+}
+
+FNeatMetadataBatch& FNeatMetadataBatch::GetOutermost()
+{
+	check(Outermost);
+	return *Outermost;
+}
+
+void FNeatMetadataBatch::Flush()
+{
+	for (const TPair<TWeakObjectPtr<UBlueprint>, FVariableWrites>& BlueprintWrites : PendingWrites)
+	{
+		UBlueprint* Blueprint = BlueprintWrites.Key.Get();
+		if (!Blueprint)
+		{
+			continue;
+		}
+
+		TArray<FNeatMetadataChange::FVariableDelta> Deltas;
+		for (const TPair<FName, FKeyWrites>& VariableWrites : BlueprintWrites.Value)
+		{
+			const FName VarName = VariableWrites.Key;
+			const int32 VarIndex = FNeatMetadataVariableIndex::Get().FindIndex(*Blueprint, VarName);
+			if (VarIndex == INDEX_NONE)
+			{
+				continue;
+			}
+
+			// Only look up the variable once, no matter how many keys were written to it.
+			FBPVariableDescription& VariableDesc = Blueprint->NewVariables[VarIndex];
+			FNeatMetadataChange::FVariableDelta Delta { VarName, VariableDesc.MetaDataArray };
+			for (const TPair<FName, TOptional<FString>>& Write : VariableWrites.Value)
+			{
+				if (Write.Value.IsSet())
+				{
+					VariableDesc.SetMetaData(Write.Key, Write.Value.GetValue());
+				}
+				else
+				{
+					VariableDesc.RemoveMetaData(Write.Key);
+				}
+			}
+			Delta.After = VariableDesc.MetaDataArray;
+
+			if (!FNeatMetadataChange::AreEqual(Delta.Before, Delta.After))
+			{
+				// The properties on the compiled classes are patched as well, so the change is visible without recompiling.
+				FNeatMetadataChange::ApplyMetadata(*Blueprint, VarName, Delta.Before, Delta.After);
+				Deltas.Add(MoveTemp(Delta));
+			}
+		}
+
+		if (Deltas.IsEmpty())
+		{
+			continue;
+		}
+
+		// Record only the metadata that changed, instead of snapshotting the whole Blueprint with Modify().
+		if (GUndo)
+		{
+			GUndo->StoreUndo(Blueprint, MakeUnique<FNeatMetadataChange>(MoveTemp(Deltas)));
+		}
+		Blueprint->MarkPackageDirty();
+	}
+
+	PendingWrites.Reset();
+}
@@ -0,0 +1,97 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#include "NeatMetadataChange.h"
+#include "NeatMetadataVariableIndex.h"
+#include "Engine/Blueprint.h"
+
+FNeatMetadataChange::FNeatMetadataChange(TArray<FVariableDelta> InDeltas) : Deltas(MoveTemp(InDeltas))
+{
+}
+
+void FNeatMetadataChange::Apply(UObject* Object)
+{
+	if (UBlueprint* Blueprint = Cast<UBlueprint>(Object))
+	{
+		for (const FVariableDelta& Delta : Deltas)
+		{
+			ApplyMetadata(*Blueprint, Delta.VarName, Delta.Before, Delta.After);
+		}
+		NotifyChanged(*Blueprint);
+	}
+}
+
+void FNeatMetadataChange::Revert(UObject* Object)
+{
+	if (UBlueprint* Blueprint = Cast<UBlueprint>(Object))
+	{
+		for (const FVariableDelta& Delta : Deltas)
+		{
+			ApplyMetadata(*Blueprint, Delta.VarName, Delta.After, Delta.Before);
+		}
+		NotifyChanged(*Blueprint);
+	}
+}
+
+FString FNeatMetadataChange::ToString() const
+{
+	return FString::Printf(TEXT("Neat Metadata Change (%d variables)"), Deltas.Num());
+}
+
+void FNeatMetadataChange::ApplyMetadata(UBlueprint& Blueprint, FName VarName, const TArray<FBPVariableMetaDataEntry>& From, const TArray<FBPVariableMetaDataEntry>& To)
+{
+	const int32 VarIndex = FNeatMetadataVariableIndex::Get().FindIndex(Blueprint, VarName);
+	if (VarIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	Blueprint.NewVariables[VarIndex].MetaDataArray = To;
+
+	FProperty* SkeletonProperty = Blueprint.SkeletonGeneratedClass ? FindFProperty<FProperty>(Blueprint.SkeletonGeneratedClass, VarName) : nullptr;
+	FProperty* GeneratedProperty = Blueprint.GeneratedClass ? FindFProperty<FProperty>(Blueprint.GeneratedClass, VarName) : nullptr;
+	for (FProperty* Property : { SkeletonProperty, GeneratedProperty })
+	{
+		if (!Property)
+		{
+			continue;
+		}
+
+		for (const FBPVariableMetaDataEntry& Entry : From)
+		{
+			if (!To.ContainsByPredicate([&Entry](const FBPVariableMetaDataEntry& InEntry) { return InEntry.DataKey == Entry.DataKey; }))
+			{
+				Property->RemoveMetaData(Entry.DataKey);
+			}
+		}
+
+		for (const FBPVariableMetaDataEntry& Entry : To)
+		{
+			Property->SetMetaData(Entry.DataKey, *Entry.DataValue);
+		}
+	}
+}
+
+void FNeatMetadataChange::NotifyChanged(UBlueprint& Blueprint)
+{
+	Blueprint.MarkPackageDirty();
+
+	// Undo and redo bypass the details panel, so open Blueprint editors have to be told to refresh.
+	// MarkBlueprintAsModified isn't used, since the compiled classes are already patched and don't need a recompile.
+	Blueprint.BroadcastChanged();
+}
+
+bool FNeatMetadataChange::AreEqual(const TArray<FBPVariableMetaDataEntry>& A, const TArray<FBPVariableMetaDataEntry>& B)
+{
+	if (A.Num() != B.Num())
+	{
+		return false;
+	}
+
+	for (int32 Idx = 0; Idx < A.Num(); Idx++)
+	{
+		if (A[Idx].DataKey != B[Idx].DataKey || !A[Idx].DataValue.Equals(B[Idx].DataValue, ESearchCase::CaseSensitive))
+		{
+			return false;
+		}
+	}
+	return true;
+}
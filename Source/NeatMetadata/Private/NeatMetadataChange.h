@@ -0,0 +1,43 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#pragma once
+#include "CoreMinimal.h"
+#include "Misc/Change.h"
+#include "Engine/Blueprint.h"
+
+/**
+ * Undo record for metadata changes on blueprint variables. Instead of snapshotting the whole Blueprint like Modify() does,
+ * this only stores the metadata of the variables that were affected, before and after the change.
+ */
+class FNeatMetadataChange : public FCommandChange
+{
+public:
+	struct FVariableDelta
+	{
+		FName VarName;
+		TArray<FBPVariableMetaDataEntry> Before;
+		TArray<FBPVariableMetaDataEntry> After;
+	};
+
+	explicit FNeatMetadataChange(TArray<FVariableDelta> InDeltas);
+
+	virtual void Apply(UObject* Object) override;
+	virtual void Revert(UObject* Object) override;
+	virtual FString ToString() const override;
+
+	/**
+	 * @brief Replaces the metadata of a blueprint variable, and patches the properties on the compiled classes to match.
+	 * @param Blueprint The blueprint that owns the variable.
+	 * @param VarName The name of the variable.
+	 * @param From The metadata the variable currently has on its compiled properties.
+	 * @param To The metadata the variable should have.
+	 */
+	static void ApplyMetadata(UBlueprint& Blueprint, FName VarName, const TArray<FBPVariableMetaDataEntry>& From, const TArray<FBPVariableMetaDataEntry>& To);
+
+	static bool AreEqual(const TArray<FBPVariableMetaDataEntry>& A, const TArray<FBPVariableMetaDataEntry>& B);
+
+private:
+	/** @brief Marks the blueprint dirty and tells open editors that it changed, after the metadata was undone or redone. */
+	static void NotifyChanged(UBlueprint& Blueprint);
+
+	TArray<FVariableDelta> Deltas;
+};
@@ -1,6 +1,8 @@
 // Copyright Viktor Pramberg. All Rights Reserved.
 #include "NeatMetadataCollection.h"
 #include "NeatMetadataWrapper.h"
+#include "NeatMetadataBatch.h"
+#include "NeatMetadataCollectionLayout.h"
 
 UNeatMetadataCollection::UNeatMetadataCollection()
 {
@@ -15,30 +17,49 @@ void UNeatMetadataCollection::InitializeFromMetadata(const FNeatMetadataWrapper&
 {
 	CurrentWrapper = MetadataWrapper;
 
-	ForEachVisibleProperty([this](const FProperty& Property)
+	// Match each metadata entry to a property in a single pass over the metadata, instead of searching it for every property.
+	const FNeatMetadataCollectionLayout& Layout = FNeatMetadataCollectionLayout::Get(*GetClass());
+	const TConstArrayView<FNeatMetadataCollectionLayout::FEntry> Entries = Layout.GetEntries();
+	TArray<const FString*, TInlineAllocator<32>> MatchedValues;
+	MatchedValues.SetNumZeroed(Entries.Num());
+	
+	CurrentWrapper.ForEachMetadata([&](FName Key, const FString& Value)
 	{
-		if (CurrentWrapper.HasMetadata(Property.GetFName()))
+		const int32 Index = Layout.FindIndex(Key);
+		if (Index != INDEX_NONE && !MatchedValues[Index])
+		{
+			MatchedValues[Index] = &Value;
+		}
+	});
+
+	// Properties are imported in field order, since dynamic visibility may depend on the values of properties declared before them.
+	for (int32 Idx = 0; Idx < Entries.Num(); Idx++)
+	{
+		if (!FNeatMetadataCollectionLayout::IsVisible(*this, Entries[Idx]))
+		{
+			continue;
+		}
+
+		const FProperty& Property = *Entries[Idx].Property;
+		if (MatchedValues[Idx])
 		{
-			const FString Value = CurrentWrapper.GetMetadata(Property.GetFName());
-			ImportValueForProperty(Property, Value);
+			ImportValueForProperty(Property, *MatchedValues[Idx]);
 		}
 		else
 		{
 			InitializeValueForProperty(Property);
 		}
-	});
+	}
 }
 
 void UNeatMetadataCollection::ForEachVisibleProperty(TFunctionRef<FForEachVisiblePropertySignature> Functor) const
 {
-	for (const FProperty* Prop : TFieldRange<FProperty>(GetClass()))
+	for (const FNeatMetadataCollectionLayout::FEntry& Entry : FNeatMetadataCollectionLayout::Get(*GetClass()).GetEntries())
 	{
-		if (!IsPropertyVisible(*Prop))
+		if (FNeatMetadataCollectionLayout::IsVisible(*this, Entry))
 		{
-			continue;
+			Functor(*Entry.Property);
 		}
-
-		Functor(*Prop);
 	}
 }
 
@@ -69,66 +90,82 @@ TSharedPtr<SWidget> UNeatMetadataCollection::CreateValueWidgetForProperty(const
 	return nullptr;
 }
 
+TSharedPtr<SWidget> UNeatMetadataCollection::CreateFooterWidget()
+{
+	return nullptr;
+}
+
+void UNeatMetadataCollection::ValidateMetadata(FNeatMetadataValidationContext& Context) const
+{
+}
+
 namespace
 {
 	template<typename T> struct TPropertyToHelper { using Type = void; };
-	template<> struct TPropertyToHelper<FArrayProperty> { using Type = FScriptArrayHelper_InContainer; };
-	template<> struct TPropertyToHelper<FMapProperty> { using Type = FScriptMapHelper_InContainer; };
-	template<> struct TPropertyToHelper<FSetProperty> { using Type = FScriptSetHelper_InContainer; };
+	template<> struct TPropertyToHelper<FArrayProperty> { using Type = FScriptArrayHelper; };
+	template<> struct TPropertyToHelper<FMapProperty> { using Type = FScriptMapHelper; };
+	template<> struct TPropertyToHelper<FSetProperty> { using Type = FScriptSetHelper; };
 	
 	template<typename T>
-	bool IsEmptyContainerOfType(const FProperty& Property, const UObject* Container)
+	bool IsEmptyContainerOfType(const FProperty& Property, const void* ValueAddr)
 	{
 		if (const T* AsContainer = CastField<T>(&Property))
 		{
-			const typename TPropertyToHelper<T>::Type Helper(AsContainer, Container);
+			const typename TPropertyToHelper<T>::Type Helper(AsContainer, ValueAddr);
 			return Helper.Num() == 0;
 		}
 		
 		return false;
 	}
 
-	bool IsEmptyContainer(const FProperty& Property, const UObject* Container)
+	bool IsEmptyContainer(const FProperty& Property, const void* ValueAddr)
 	{
-		return IsEmptyContainerOfType<FArrayProperty>(Property, Container)
-			|| IsEmptyContainerOfType<FMapProperty>(Property, Container)
-			|| IsEmptyContainerOfType<FSetProperty>(Property, Container);
+		return IsEmptyContainerOfType<FArrayProperty>(Property, ValueAddr)
+			|| IsEmptyContainerOfType<FMapProperty>(Property, ValueAddr)
+			|| IsEmptyContainerOfType<FSetProperty>(Property, ValueAddr);
 	}
 }
 
 TOptional<FString> UNeatMetadataCollection::ExportValueForProperty(FProperty& Property) const
 {
-	if (const FBoolProperty* AsBool = CastField<FBoolProperty>(&Property))
-	{
-		static const FString TrueReturnValue = FString(TEXT("true"));
-		return AsBool->GetPropertyValue_InContainer(this) ? TOptional(TrueReturnValue) : NullOpt;
-	}
-
-	if (const FObjectPropertyBase* AsObject = CastField<FObjectPropertyBase>(&Property))
+	const FNeatMetadataCollectionLayout::FEntry* FoundEntry = FNeatMetadataCollectionLayout::Get(*GetClass()).Find(Property.GetFName());
+	const FNeatMetadataCollectionLayout::FEntry Entry = FoundEntry ? *FoundEntry : FNeatMetadataCollectionLayout::FEntry::Make(Property);
+	const uint8* ValueAddr = reinterpret_cast<const uint8*>(this) + Entry.Offset;
+	
+	switch (Entry.Codec)
 	{
-		if (!AsObject->GetObjectPropertyValue_InContainer(this))
+	case ENeatMetadataCodec::Bool:
+		{
+			static const FString TrueReturnValue = FString(TEXT("true"));
+			return CastFieldChecked<const FBoolProperty>(Entry.Property)->GetPropertyValue(ValueAddr) ? TOptional(TrueReturnValue) : NullOpt;
+		}
+	case ENeatMetadataCodec::Object:
+		if (!CastFieldChecked<const FObjectPropertyBase>(Entry.Property)->GetObjectPropertyValue(ValueAddr))
 		{
 			return {};
 		}
-	}
-	
-	if (IsEmptyContainer(Property, this))
-	{
-		return {};
+		break;
+	case ENeatMetadataCodec::Container:
+		if (IsEmptyContainer(Property, ValueAddr))
+		{
+			return {};
+		}
+		break;
+	default:
+		break;
 	}
 
 	FString Value;
-	if (Property.ArrayDim == 1)
+	if (Entry.ArrayDim == 1)
 	{
-		Property.ExportText_InContainer(0, Value, this, this, nullptr, 0);
+		Property.ExportTextItem_Direct(Value, ValueAddr, ValueAddr, nullptr, PPF_None);
 	}
 	else
 	{
-		const void* ValueAddr = Property.ContainerPtrToValuePtr<void>(this);
-		FArrayProperty::ExportTextInnerItem(Value, &Property, ValueAddr, Property.ArrayDim, ValueAddr, Property.ArrayDim);
+		FArrayProperty::ExportTextInnerItem(Value, &Property, ValueAddr, Entry.ArrayDim, ValueAddr, Entry.ArrayDim);
 	}
 
-	if (Property.IsA<FStrProperty>() && Value.IsEmpty())
+	if (Entry.Codec == ENeatMetadataCodec::String && Value.IsEmpty())
 	{
 		return {};
 	}
@@ -138,17 +175,20 @@ TOptional<FString> UNeatMetadataCollection::ExportValueForProperty(FProperty& Pr
 
 void UNeatMetadataCollection::ImportValueForProperty(const FProperty& Property, const FString& Value)
 {
-	if (const FBoolProperty* BoolProp = CastField<FBoolProperty>(&Property))
+	const FNeatMetadataCollectionLayout::FEntry* FoundEntry = FNeatMetadataCollectionLayout::Get(*GetClass()).Find(Property.GetFName());
+	const FNeatMetadataCollectionLayout::FEntry Entry = FoundEntry ? *FoundEntry : FNeatMetadataCollectionLayout::FEntry::Make(Property);
+	uint8* ValueAddr = reinterpret_cast<uint8*>(this) + Entry.Offset;
+	
+	if (Entry.Codec == ENeatMetadataCodec::Bool)
 	{
-		BoolProp->SetPropertyValue_InContainer(this, true);
+		CastFieldChecked<const FBoolProperty>(Entry.Property)->SetPropertyValue(ValueAddr, true);
 	}
-	else if (Property.ArrayDim == 1)
+	else if (Entry.ArrayDim == 1)
 	{
-		Property.ImportText_InContainer(*Value, this, this, 0);
+		Property.ImportText_Direct(*Value, ValueAddr, this, PPF_None);
 	}
 	else
 	{
-		void* ValueAddr = Property.ContainerPtrToValuePtr<void>(this);
 		FArrayProperty::ImportTextInnerItem(*Value, &Property, ValueAddr, PPF_None, this);
 	}
 }
@@ -172,8 +212,33 @@ void UNeatMetadataCollection::PostEditChangeProperty(FPropertyChangedEvent& Prop
 		return;
 	}
 	
-	const FName PropertyName = PropertyChangedEvent.GetMemberPropertyName();
-	if (const auto OptionalValue = ExportValueForProperty(*PropertyChangedEvent.MemberProperty))
+	WriteMetadataForProperty(*PropertyChangedEvent.MemberProperty);
+}
+
+bool UNeatMetadataCollection::ApplyValue(FName InPropertyName, const FString& InValue)
+{
+	FProperty* Property = FindFProperty<FProperty>(GetClass(), InPropertyName);
+	if (!Property || !CurrentWrapper.IsValid())
+	{
+		return false;
+	}
+
+	if (!Property->ImportText_InContainer(*InValue, this, this, PPF_None))
+	{
+		return false;
+	}
+
+	WriteMetadataForProperty(*Property);
+	return true;
+}
+
+void UNeatMetadataCollection::WriteMetadataForProperty(FProperty& Property)
+{
+	// Some collections write additional keys while exporting, so make sure they are all flushed together.
+	FNeatMetadataBatch Batch;
+	
+	const FName PropertyName = Property.GetFName();
+	if (const auto OptionalValue = ExportValueForProperty(Property))
 	{
 		CurrentWrapper.SetMetadata(PropertyName, *OptionalValue);
 	}
@@ -188,6 +253,11 @@ bool UNeatMetadataCollection::IsPropertyVisible(const FProperty& Property) const
 	return !Property.HasAnyPropertyFlags(CPF_DisableEditOnInstance);
 }
 
+bool UNeatMetadataCollection::IsPropertyVisibilityDynamic(const FProperty& Property) const
+{
+	return false;
+}
+
 bool UNeatMetadataCollectionStruct::IsRelevantForContainedProperty(const FProperty& InProperty) const
 {
 	if (const FStructProperty* AsStruct = CastField<FStructProperty>(&InProperty))
@@ -0,0 +1,99 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#include "NeatMetadataCollectionLayout.h"
+#include "NeatMetadataCollection.h"
+#include "UObject/ObjectKey.h"
+
+namespace
+{
+	TMap<FObjectKey, TUniquePtr<FNeatMetadataCollectionLayout>>& GetLayouts()
+	{
+		static TMap<FObjectKey, TUniquePtr<FNeatMetadataCollectionLayout>> Layouts;
+		return Layouts;
+	}
+
+	ENeatMetadataCodec GetCodec(const FProperty& InProperty)
+	{
+		if (InProperty.IsA<FBoolProperty>())
+		{
+			return ENeatMetadataCodec::Bool;
+		}
+
+		if (InProperty.IsA<FObjectPropertyBase>())
+		{
+			return ENeatMetadataCodec::Object;
+		}
+
+		if (InProperty.IsA<FArrayProperty>() || InProperty.IsA<FMapProperty>() || InProperty.IsA<FSetProperty>())
+		{
+			return ENeatMetadataCodec::Container;
+		}
+
+		if (InProperty.IsA<FStrProperty>())
+		{
+			return ENeatMetadataCodec::String;
+		}
+
+		return ENeatMetadataCodec::Text;
+	}
+}
+
+FNeatMetadataCollectionLayout::FEntry FNeatMetadataCollectionLayout::FEntry::Make(const FProperty& InProperty)
+{
+	FEntry Entry;
+	Entry.Property = &InProperty;
+	Entry.Name = InProperty.GetFName();
+	Entry.Offset = InProperty.GetOffset_ForInternal();
+	Entry.ArrayDim = InProperty.ArrayDim;
+	Entry.Codec = GetCodec(InProperty);
+	return Entry;
+}
+
+const FNeatMetadataCollectionLayout& FNeatMetadataCollectionLayout::Get(const UClass& InClass)
+{
+	check(IsInGameThread());
+
+	TUniquePtr<FNeatMetadataCollectionLayout>& Layout = GetLayouts().FindOrAdd(FObjectKey(&InClass));
+	if (!Layout)
+	{
+		Layout = TUniquePtr<FNeatMetadataCollectionLayout>(new FNeatMetadataCollectionLayout(InClass));
+	}
+	return *Layout;
+}
+
+void FNeatMetadataCollectionLayout::Reset()
+{
+	GetLayouts().Reset();
+}
+
+const FNeatMetadataCollectionLayout::FEntry* FNeatMetadataCollectionLayout::Find(FName InKey) const
+{
+	const int32 Index = FindIndex(InKey);
+	return Index != INDEX_NONE ? &Entries[Index] : nullptr;
+}
+
+int32 FNeatMetadataCollectionLayout::FindIndex(FName InKey) const
+{
+	const int32* Found = NameToIndex.Find(InKey);
+	return Found ? *Found : INDEX_NONE;
+}
+
+bool FNeatMetadataCollectionLayout::IsVisible(const UNeatMetadataCollection& InCollection, const FEntry& InEntry)
+{
+	return InEntry.bDynamicVisibility ? InCollection.IsPropertyVisible(*InEntry.Property) : InEntry.bStaticallyVisible;
+}
+
+FNeatMetadataCollectionLayout::FNeatMetadataCollectionLayout(const UClass& InClass)
+{
+	const UNeatMetadataCollection* CDO = CastChecked<UNeatMetadataCollection>(InClass.GetDefaultObject());
+
+	for (const FProperty* Property : TFieldRange<FProperty>(&InClass))
+	{
+		FEntry Entry = FEntry::Make(*Property);
+
+		// Dynamic visibility may depend on the wrapped property, which the CDO doesn't have, so it is never evaluated here.
+		Entry.bDynamicVisibility = CDO->IsPropertyVisibilityDynamic(*Property);
+		Entry.bStaticallyVisible = Entry.bDynamicVisibility || CDO->IsPropertyVisible(*Property);
+
+		NameToIndex.Add(Entry.Name, Entries.Add(MoveTemp(Entry)));
+	}
+}
@@ -0,0 +1,76 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#pragma once
+#include "CoreMinimal.h"
+
+class UNeatMetadataCollection;
+
+// How a property on a collection is converted to and from a metadata string.
+enum class ENeatMetadataCodec : uint8
+{
+	// Exported as "true", removed when false.
+	Bool,
+	// Removed when the object is null, otherwise exported as text.
+	Object,
+	// Removed when the array, map or set is empty, otherwise exported as text.
+	Container,
+	// Removed when the exported string is empty.
+	String,
+	// Always exported as text.
+	Text,
+};
+
+/**
+ * Static information about the properties of a metadata collection class, computed once per class. Allows metadata keys
+ * to be mapped to properties through a hash lookup, and avoids evaluating visibility and property types over and over.
+ */
+class FNeatMetadataCollectionLayout
+{
+public:
+	struct FEntry
+	{
+		const FProperty* Property = nullptr;
+		// Name of the property, which is also the metadata key it is stored under.
+		FName Name;
+		int32 Offset = 0;
+		int32 ArrayDim = 1;
+		ENeatMetadataCodec Codec = ENeatMetadataCodec::Text;
+		// Whether visibility depends on the wrapped property, and has to be evaluated per selection.
+		bool bDynamicVisibility = false;
+		// Visibility of properties that don't have dynamic visibility.
+		bool bStaticallyVisible = true;
+
+		static FEntry Make(const FProperty& InProperty);
+	};
+
+	/**
+	 * @brief Finds or builds the layout for a collection class.
+	 * @param InClass A UNeatMetadataCollection class.
+	 */
+	static const FNeatMetadataCollectionLayout& Get(const UClass& InClass);
+
+	// Discards all cached layouts. Must be called when collection classes may have been reinstanced.
+	static void Reset();
+
+	// All properties of the class, in field order.
+	TConstArrayView<FEntry> GetEntries() const { return Entries; }
+
+	/**
+	 * @brief Finds the property that stores the input metadata key.
+	 * @return The entry, or nullptr.
+	 */
+	const FEntry* Find(FName InKey) const;
+	int32 FindIndex(FName InKey) const;
+
+	/**
+	 * @brief Is the entry visible on the input collection? Only entries with dynamic visibility are evaluated.
+	 * @param InCollection The collection that is being edited, initialized with the current wrapper.
+	 * @param InEntry An entry from the layout of the collection's class.
+	 */
+	static bool IsVisible(const UNeatMetadataCollection& InCollection, const FEntry& InEntry);
+
+private:
+	explicit FNeatMetadataCollectionLayout(const UClass& InClass);
+
+	TArray<FEntry> Entries;
+	TMap<FName, int32> NameToIndex;
+};
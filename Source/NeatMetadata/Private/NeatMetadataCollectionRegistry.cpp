@@ -0,0 +1,346 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#include "NeatMetadataCollectionRegistry.h"
+#include "NeatMetadataCollection.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Editor.h"
+#include "Engine/Blueprint.h"
+#include "Kismet2/KismetEditorUtilities.h"
+#include "UObject/UObjectHash.h"
+
+#if WITH_LIVE_CODING
+#include "ILiveCodingModule.h"
+#endif
+
+TUniquePtr<FNeatMetadataCollectionRegistry> FNeatMetadataCollectionRegistry::Instance;
+
+FNeatMetadataCollectionRegistry& FNeatMetadataCollectionRegistry::Get()
+{
+	if (!Instance)
+	{
+		Instance = TUniquePtr<FNeatMetadataCollectionRegistry>(new FNeatMetadataCollectionRegistry());
+	}
+	return *Instance;
+}
+
+void FNeatMetadataCollectionRegistry::TearDown()
+{
+	Instance.Reset();
+}
+
+FNeatMetadataCollectionRegistry::FNeatMetadataCollectionRegistry()
+{
+	// The only full build. Derived classes are looked up through the class hash, so this doesn't touch unrelated classes.
+	TArray<UClass*> DerivedClasses;
+	GetDerivedClasses(UNeatMetadataCollection::StaticClass(), DerivedClasses, true);
+	for (UClass* Class : DerivedClasses)
+	{
+		AddClassInternal(Class);
+	}
+
+	ModulesChangedHandle = FModuleManager::Get().OnModulesChanged().AddRaw(this, &FNeatMetadataCollectionRegistry::OnModulesChanged);
+	AssetLoadedHandle = FCoreUObjectDelegates::OnAssetLoaded.AddRaw(this, &FNeatMetadataCollectionRegistry::OnAssetLoaded);
+	ReloadAddedClassesHandle = FCoreUObjectDelegates::ReloadAddedClassesDelegate.AddRaw(this, &FNeatMetadataCollectionRegistry::OnReloadAddedClasses);
+	ReloadCompleteHandle = FCoreUObjectDelegates::ReloadCompleteDelegate.AddRaw(this, &FNeatMetadataCollectionRegistry::OnReloadComplete);
+
+	if (GEditor)
+	{
+		BlueprintCompiledHandle = GEditor->OnBlueprintCompiled().AddRaw(this, &FNeatMetadataCollectionRegistry::OnBlueprintCompiled);
+	}
+
+#if WITH_LIVE_CODING
+	if (ILiveCodingModule* LiveCoding = FModuleManager::GetModulePtr<ILiveCodingModule>(LIVE_CODING_MODULE_NAME))
+	{
+		LiveCodingPatchCompleteHandle = LiveCoding->GetOnPatchCompleteDelegate().AddRaw(this, &FNeatMetadataCollectionRegistry::OnLiveCodingPatchComplete);
+	}
+#endif
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(AssetRegistryConstants::ModuleName).Get();
+	if (AssetRegistry.IsLoadingAssets())
+	{
+		FilesLoadedHandle = AssetRegistry.OnFilesLoaded().AddRaw(this, &FNeatMetadataCollectionRegistry::DiscoverBlueprintCollections);
+	}
+	else
+	{
+		DiscoverBlueprintCollections();
+	}
+}
+
+FNeatMetadataCollectionRegistry::~FNeatMetadataCollectionRegistry()
+{
+	if (FModuleManager* ModuleManager = FModuleManager::GetModuleManagerIfExists())
+	{
+		ModuleManager->OnModulesChanged().Remove(ModulesChangedHandle);
+	}
+	if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>(AssetRegistryConstants::ModuleName))
+	{
+		AssetRegistryModule->Get().OnFilesLoaded().Remove(FilesLoadedHandle);
+		AssetRegistryModule->Get().OnAssetAdded().Remove(AssetAddedHandle);
+	}
+	for (const TPair<FSoftObjectPath, TSharedPtr<FStreamableHandle>>& Pending : PendingLoads)
+	{
+		Pending.Value->CancelHandle();
+	}
+	FCoreUObjectDelegates::OnAssetLoaded.Remove(AssetLoadedHandle);
+	FCoreUObjectDelegates::ReloadAddedClassesDelegate.Remove(ReloadAddedClassesHandle);
+	FCoreUObjectDelegates::ReloadCompleteDelegate.Remove(ReloadCompleteHandle);
+
+	if (GEditor)
+	{
+		GEditor->OnBlueprintCompiled().Remove(BlueprintCompiledHandle);
+	}
+
+#if WITH_LIVE_CODING
+	if (ILiveCodingModule* LiveCoding = FModuleManager::GetModulePtr<ILiveCodingModule>(LIVE_CODING_MODULE_NAME))
+	{
+		LiveCoding->GetOnPatchCompleteDelegate().Remove(LiveCodingPatchCompleteHandle);
+	}
+#endif
+}
+
+void FNeatMetadataCollectionRegistry::ForEachClass(TFunctionRef<FForEachClassSignature> Functor) const
+{
+	for (const TPair<FObjectKey, TWeakObjectPtr<UClass>>& Pair : Classes)
+	{
+		if (UClass* Class = Pair.Value.Get(); Class && IsCollectionClass(Class))
+		{
+			Functor(*Class);
+		}
+	}
+}
+
+bool FNeatMetadataCollectionRegistry::Contains(const UClass* InClass) const
+{
+	return InClass && Classes.Contains(FObjectKey(InClass)) && IsCollectionClass(InClass);
+}
+
+bool FNeatMetadataCollectionRegistry::AddClass(UClass* InClass)
+{
+	if (!AddClassInternal(InClass))
+	{
+		return false;
+	}
+
+	NotifyChanged();
+	return true;
+}
+
+bool FNeatMetadataCollectionRegistry::IsCollectionClass(const UClass* InClass)
+{
+	if (!InClass || !InClass->IsChildOf(UNeatMetadataCollection::StaticClass()))
+	{
+		return false;
+	}
+
+	if (InClass->HasAnyClassFlags(CLASS_Abstract | CLASS_Deprecated | CLASS_NewerVersionExists))
+	{
+		return false;
+	}
+
+	// Skeleton classes only exist to support the Blueprint editor, the generated class is the one we want.
+	return !FKismetEditorUtilities::IsClassABlueprintSkeleton(InClass);
+}
+
+bool FNeatMetadataCollectionRegistry::AddClassInternal(UClass* InClass)
+{
+	if (!IsCollectionClass(InClass))
+	{
+		return false;
+	}
+
+	const FObjectKey Key(InClass);
+	if (Classes.Contains(Key))
+	{
+		return false;
+	}
+
+	Classes.Add(Key, InClass);
+	return true;
+}
+
+bool FNeatMetadataCollectionRegistry::PruneStaleClasses()
+{
+	bool bChanged = false;
+	for (auto It = Classes.CreateIterator(); It; ++It)
+	{
+		if (!IsCollectionClass(It->Value.Get()))
+		{
+			It.RemoveCurrent();
+			bChanged = true;
+		}
+	}
+
+	return bChanged;
+}
+
+void FNeatMetadataCollectionRegistry::RequestAsyncLoad(const FSoftObjectPath& InClassPath)
+{
+	if (InClassPath.IsNull() || PendingLoads.Contains(InClassPath))
+	{
+		return;
+	}
+
+	if (UClass* LoadedClass = Cast<UClass>(InClassPath.ResolveObject()))
+	{
+		AddClass(LoadedClass);
+		return;
+	}
+
+	const FStreamableDelegate OnLoaded = FStreamableDelegate::CreateRaw(this, &FNeatMetadataCollectionRegistry::OnAsyncLoadComplete, InClassPath);
+	if (TSharedPtr<FStreamableHandle> Handle = StreamableManager.RequestAsyncLoad(InClassPath, OnLoaded))
+	{
+		// The delegate may already have been executed if the class was loaded in the meantime.
+		if (Handle->IsLoadingInProgress())
+		{
+			PendingLoads.Add(InClassPath, MoveTemp(Handle));
+		}
+	}
+}
+
+void FNeatMetadataCollectionRegistry::DiscoverBlueprintCollections()
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(AssetRegistryConstants::ModuleName).Get();
+	AssetRegistry.OnFilesLoaded().Remove(FilesLoadedHandle);
+
+	// The asset registry knows about the class hierarchy of unloaded Blueprints through their parent class tags.
+	TSet<FTopLevelAssetPath> DerivedClassPaths;
+	AssetRegistry.GetDerivedClassNames({ UNeatMetadataCollection::StaticClass()->GetClassPathName() }, {}, DerivedClassPaths);
+	for (const FTopLevelAssetPath& ClassPath : DerivedClassPaths)
+	{
+		// Native classes are already handled when their module is loaded.
+		if (!FPackageName::IsScriptPackage(ClassPath.GetPackageName().ToString()))
+		{
+			RequestAsyncLoad(FSoftObjectPath(ClassPath));
+		}
+	}
+
+	// Pick up Blueprint collections in content that is mounted later on.
+	AssetAddedHandle = AssetRegistry.OnAssetAdded().AddRaw(this, &FNeatMetadataCollectionRegistry::OnAssetAdded);
+}
+
+void FNeatMetadataCollectionRegistry::OnAssetAdded(const FAssetData& InAssetData)
+{
+	const FString NativeParentClassPath = InAssetData.GetTagValueRef<FString>(FBlueprintTags::NativeParentClassPath);
+	if (NativeParentClassPath.IsEmpty())
+	{
+		return;
+	}
+
+	const UClass* NativeParentClass = FindObject<UClass>(nullptr, *FPackageName::ExportTextPathToObjectPath(NativeParentClassPath));
+	if (!NativeParentClass || !NativeParentClass->IsChildOf(UNeatMetadataCollection::StaticClass()))
+	{
+		return;
+	}
+
+	const FString GeneratedClassPath = InAssetData.GetTagValueRef<FString>(FBlueprintTags::GeneratedClassPath);
+	if (!GeneratedClassPath.IsEmpty())
+	{
+		RequestAsyncLoad(FSoftObjectPath(FPackageName::ExportTextPathToObjectPath(GeneratedClassPath)));
+	}
+}
+
+void FNeatMetadataCollectionRegistry::OnAsyncLoadComplete(FSoftObjectPath InClassPath)
+{
+	PendingLoads.Remove(InClassPath);
+
+	UClass* LoadedClass = Cast<UClass>(InClassPath.ResolveObject());
+	if (!AddClass(LoadedClass) && Contains(LoadedClass))
+	{
+		// The class was already known, but whoever asked for it may not have been able to use it until now.
+		NotifyChanged();
+	}
+}
+
+void FNeatMetadataCollectionRegistry::NotifyChanged()
+{
+	ChangedDelegate.Broadcast();
+}
+
+void FNeatMetadataCollectionRegistry::OnModulesChanged(FName ModuleName, EModuleChangeReason Reason)
+{
+	if (Reason != EModuleChangeReason::ModuleLoaded)
+	{
+		return;
+	}
+
+	// Only look at the classes that were added by the module that was loaded.
+	const UPackage* ScriptPackage = FindPackage(nullptr, *FString::Printf(TEXT("/Script/%s"), *ModuleName.ToString()));
+	if (!ScriptPackage)
+	{
+		return;
+	}
+
+	bool bChanged = false;
+	ForEachObjectWithPackage(ScriptPackage, [&](UObject* Object)
+	{
+		if (UClass* AsClass = Cast<UClass>(Object))
+		{
+			bChanged |= AddClassInternal(AsClass);
+		}
+		return true;
+	}, false);
+
+	if (bChanged)
+	{
+		NotifyChanged();
+	}
+}
+
+void FNeatMetadataCollectionRegistry::OnAssetLoaded(UObject* InObject)
+{
+	if (const UBlueprint* AsBlueprint = Cast<UBlueprint>(InObject))
+	{
+		AddClass(AsBlueprint->GeneratedClass);
+	}
+}
+
+void FNeatMetadataCollectionRegistry::OnBlueprintCompiled()
+{
+	// Compiling replaces the old generated class with a new one, and may also be the first time a new Blueprint collection
+	// gets a generated class at all.
+	RefreshFromClassHash();
+}
+
+void FNeatMetadataCollectionRegistry::OnReloadAddedClasses(const TArray<UClass*>& InClasses)
+{
+	bool bChanged = false;
+	for (UClass* Class : InClasses)
+	{
+		bChanged |= AddClassInternal(Class);
+	}
+
+	if (bChanged)
+	{
+		NotifyChanged();
+	}
+}
+
+void FNeatMetadataCollectionRegistry::OnReloadComplete(EReloadCompleteReason Reason)
+{
+	RefreshFromClassHash();
+}
+
+void FNeatMetadataCollectionRegistry::OnLiveCodingPatchComplete()
+{
+	RefreshFromClassHash();
+}
+
+void FNeatMetadataCollectionRegistry::RefreshFromClassHash()
+{
+	// Reinstanced classes are flagged with CLASS_NewerVersionExists, so they are pruned here. The derived class lookup goes
+	// through the class hash, which only touches collection classes.
+	bool bChanged = false;
+	TArray<UClass*> DerivedClasses;
+	GetDerivedClasses(UNeatMetadataCollection::StaticClass(), DerivedClasses, true);
+	for (UClass* Class : DerivedClasses)
+	{
+		bChanged |= AddClassInternal(Class);
+	}
+
+	bChanged |= PruneStaleClasses();
+
+	if (bChanged)
+	{
+		NotifyChanged();
+	}
+}
@@ -0,0 +1,105 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#pragma once
+#include "CoreMinimal.h"
+#include "Modules/ModuleManager.h"
+#include "UObject/ObjectKey.h"
+#include "Engine/StreamableManager.h"
+
+struct FAssetData;
+
+class UNeatMetadataCollection;
+enum class EReloadCompleteReason;
+
+/**
+ * Persistent registry of all concrete UNeatMetadataCollection subclasses that are currently in memory.
+ *
+ * The registry is built once, and is then kept up to date incrementally when modules are loaded, when Blueprint
+ * collections are loaded or compiled, and when classes are added through hot reload or Live Coding. Consumers can
+ * then work on the (small) set of collection classes, instead of walking every UClass in memory.
+ *
+ * Blueprint collections that aren't loaded are discovered through the asset registry, and are then streamed in
+ * asynchronously. Each of them joins the registry as soon as it has been loaded.
+ */
+class FNeatMetadataCollectionRegistry
+{
+public:
+	static FNeatMetadataCollectionRegistry& Get();
+	static void TearDown();
+
+	~FNeatMetadataCollectionRegistry();
+
+	using FForEachClassSignature = void(UClass&);
+	/**
+	 * @brief Loops through all registered collection classes.
+	 * @param Functor Functor that executes for each class.
+	 */
+	void ForEachClass(TFunctionRef<FForEachClassSignature> Functor) const;
+
+	/**
+	 * @brief Is the input class a registered collection class?
+	 * @param InClass The class to test.
+	 * @return True if the class is a concrete, up to date collection class.
+	 */
+	bool Contains(const UClass* InClass) const;
+
+	/**
+	 * @brief Adds a class to the registry, if it is a valid collection class.
+	 * @param InClass The class to add.
+	 * @return True if the registry changed.
+	 */
+	bool AddClass(UClass* InClass);
+
+	/**
+	 * @brief Loads a collection class asynchronously. OnChanged is broadcast once it has been loaded.
+	 * @param InClassPath Path to the class to load.
+	 */
+	void RequestAsyncLoad(const FSoftObjectPath& InClassPath);
+
+	// Broadcast whenever classes have been added to, or removed from, the registry.
+	FSimpleMulticastDelegate& OnChanged() { return ChangedDelegate; }
+
+	/**
+	 * @brief Whether the input class should be part of the registry.
+	 * @param InClass The class to test.
+	 * @return True for non-abstract, non-deprecated, up to date collection classes.
+	 */
+	static bool IsCollectionClass(const UClass* InClass);
+
+private:
+	FNeatMetadataCollectionRegistry();
+
+	bool AddClassInternal(UClass* InClass);
+	bool PruneStaleClasses();
+	void NotifyChanged();
+
+	void DiscoverBlueprintCollections();
+	void OnAssetAdded(const FAssetData& InAssetData);
+	void OnAsyncLoadComplete(FSoftObjectPath InClassPath);
+
+	void OnModulesChanged(FName ModuleName, EModuleChangeReason Reason);
+	void OnAssetLoaded(UObject* InObject);
+	void OnBlueprintCompiled();
+	void OnReloadAddedClasses(const TArray<UClass*>& InClasses);
+	void OnReloadComplete(EReloadCompleteReason Reason);
+	void OnLiveCodingPatchComplete();
+	void RefreshFromClassHash();
+
+	TMap<FObjectKey, TWeakObjectPtr<UClass>> Classes;
+	FSimpleMulticastDelegate ChangedDelegate;
+
+	FStreamableManager StreamableManager;
+	TMap<FSoftObjectPath, TSharedPtr<FStreamableHandle>> PendingLoads;
+
+	FDelegateHandle FilesLoadedHandle;
+	FDelegateHandle AssetAddedHandle;
+	FDelegateHandle ModulesChangedHandle;
+	FDelegateHandle AssetLoadedHandle;
+	FDelegateHandle BlueprintCompiledHandle;
+	FDelegateHandle ReloadAddedClassesHandle;
+	FDelegateHandle ReloadCompleteHandle;
+#if WITH_LIVE_CODING
+	FDelegateHandle LiveCodingPatchCompleteHandle;
+#endif
+
+	static TUniquePtr<FNeatMetadataCollectionRegistry> Instance;
+};
@@ -1,18 +1,28 @@
 ﻿// Copyright Viktor Pramberg. All Rights Reserved.
 #include "NeatMetadataCollections.h"
 #include "NeatMetadataModule.h"
+#include "NeatMetadataSettings.h"
 
 #include "Widgets/SNeatInterfaceSelector.h"
 #include "Widgets/SNeatFunctionSelector.h"
+#include "Widgets/SNeatRowTypeSelector.h"
+#include "Widgets/SNeatAssetBundleSelector.h"
+#include "Widgets/SNeatAssetFilterPreview.h"
+#include "NeatRowStructCatalog.h"
+#include "NeatOptionsFunctionCache.h"
+#include "NeatMetadataReferenceIndex.h"
 
 #include "Curves/CurveLinearColor.h"
 #include "Curves/CurveVector.h"
 
 #include "Kismet2/BlueprintEditorUtils.h"
 #include "BlueprintEditorModule.h"
-#include "DataTableEditorUtils.h"
+#include "DetailLayoutBuilder.h"
+#include "Styling/StyleColors.h"
 
 #include "Algo/Transform.h"
+#include "String/ParseTokens.h"
+#include "GameplayTagsModule.h"
 
 namespace
 {
@@ -26,6 +36,27 @@ namespace
 	
 		return InProperty.IsA<FNumericProperty>() && !InProperty.IsA<FEnumProperty>();
 	}
+
+	// Returns the inner property if the input is a container, or the value property if it is a map.
+	const FProperty* GetContainedProperty(const FProperty& InProperty)
+	{
+		if (const FArrayProperty* AsArray = CastField<FArrayProperty>(&InProperty))
+		{
+			return AsArray->Inner;
+		}
+
+		if (const FSetProperty* AsSet = CastField<FSetProperty>(&InProperty))
+		{
+			return AsSet->ElementProp;
+		}
+
+		if (const FMapProperty* AsMap = CastField<FMapProperty>(&InProperty))
+		{
+			return AsMap->GetValueProperty();
+		}
+
+		return &InProperty;
+	}
 }
 
 #pragma region Edit Condition
@@ -68,6 +99,33 @@ bool UNeatMetadataCollection_EditCondition::IsPropertyVisible(const FProperty& P
 	
 	return true;
 }
+
+bool UNeatMetadataCollection_EditCondition::IsPropertyVisibilityDynamic(const FProperty& Property) const
+{
+	static const FName InlineEditConditionToggleName(GET_MEMBER_NAME_CHECKED(ThisClass, InlineEditConditionToggle));
+	static const FName EditConditionHidesName(GET_MEMBER_NAME_CHECKED(ThisClass, EditConditionHides));
+	static const FName HideEditConditionToggleName(GET_MEMBER_NAME_CHECKED(ThisClass, HideEditConditionToggle));
+	const FName Name = Property.GetFName();
+	return Name == InlineEditConditionToggleName || Name == EditConditionHidesName || Name == HideEditConditionToggleName;
+}
+
+void UNeatMetadataCollection_EditCondition::ValidateMetadata(FNeatMetadataValidationContext& Context) const
+{
+	const UClass* OwnerClass = CurrentWrapper.IsValid() ? CurrentWrapper.GetProperty()->GetOwnerClass() : nullptr;
+	if (EditCondition.IsEmpty() || !OwnerClass)
+	{
+		return;
+	}
+
+	// Only the names are checked, the rest of the expression is left to the engine's parser.
+	FNeatMetadataReferenceIndex::ForEachSymbol(NAME_None, GET_MEMBER_NAME_CHECKED(ThisClass, EditCondition), EditCondition, [&](const FNeatMetadataReferenceIndex::FSymbol& Symbol, int32, int32)
+	{
+		if (!FindFProperty<FProperty>(OwnerClass, Symbol.Name))
+		{
+			Context.AddError(FString::Printf(TEXT("The edit condition \"%s\" refers to %s, which is not a variable."), *EditCondition, *Symbol.Name.ToString()));
+		}
+	});
+}
 #pragma endregion
 
 #pragma region Gameplay Tag Categories
@@ -95,19 +153,110 @@ void UNeatMetadataCollection_GameplayTagCategories::ImportValueForProperty(const
 {
 	if (Property.GetFName() == GET_MEMBER_NAME_CHECKED(ThisClass, Categories))
 	{
-		TArray<FString> Tags;
-		Value.ParseIntoArray(Tags, TEXT(","));
-		Categories.Reset(Tags.Num());
-		for (const FString Tag : Tags)
-		{
-			Categories.AddTagFast(FGameplayTag::RequestGameplayTag(FName(Tag)));
-		}
+		Categories = FindOrParseCategories(Value).Tags;
 	}
 	else
 	{
 		Super::ImportValueForProperty(Property, Value);
 	}
 }
+
+void UNeatMetadataCollection_GameplayTagCategories::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	if (!HasAnyFlags(RF_ClassDefaultObject))
+	{
+		TagTreeChangedHandle = IGameplayTagsModule::OnGameplayTagTreeChanged.AddUObject(this, &ThisClass::OnGameplayTagTreeChanged);
+	}
+}
+
+void UNeatMetadataCollection_GameplayTagCategories::BeginDestroy()
+{
+	IGameplayTagsModule::OnGameplayTagTreeChanged.Remove(TagTreeChangedHandle);
+	Super::BeginDestroy();
+}
+
+TSharedPtr<SWidget> UNeatMetadataCollection_GameplayTagCategories::CreateFooterWidget()
+{
+	// Missing tags are dropped from Categories when it is imported, so the error has to come from the raw metadata.
+	// The collection is shared by all properties, so hold on to the wrapper of the property that this widget is for.
+	const TWeakObjectPtr<const ThisClass> WeakThis = this;
+	const FNeatMetadataWrapper Wrapper = CurrentWrapper;
+	auto GetError = [WeakThis, Wrapper]() -> TOptional<FString>
+	{
+		if (!WeakThis.IsValid() || !Wrapper.IsValid())
+		{
+			return {};
+		}
+		return WeakThis->GetMissingCategoriesError(Wrapper.GetMetadata(GET_MEMBER_NAME_CHECKED(ThisClass, Categories)));
+	};
+
+	return SNew(STextBlock)
+		.AutoWrapText(true)
+		.Margin(FMargin(0.0f, 2.0f))
+		.Font(IDetailLayoutBuilder::GetDetailFont())
+		.ColorAndOpacity(FStyleColors::Error)
+		.Text_Lambda([GetError]() { const TOptional<FString> Error = GetError(); return Error ? FText::FromString(*Error) : FText(); })
+		.Visibility_Lambda([GetError]() { return GetError() ? EVisibility::Visible : EVisibility::Collapsed; });
+}
+
+void UNeatMetadataCollection_GameplayTagCategories::ValidateMetadata(FNeatMetadataValidationContext& Context) const
+{
+	if (!CurrentWrapper.IsValid())
+	{
+		return;
+	}
+
+	if (TOptional<FString> Error = GetMissingCategoriesError(CurrentWrapper.GetMetadata(GET_MEMBER_NAME_CHECKED(ThisClass, Categories))))
+	{
+		Context.AddError(MoveTemp(Error.GetValue()));
+	}
+}
+
+const UNeatMetadataCollection_GameplayTagCategories::FParsedCategories& UNeatMetadataCollection_GameplayTagCategories::FindOrParseCategories(const FString& Value) const
+{
+	if (const FParsedCategories* Found = ParsedCategories.Find(Value))
+	{
+		return *Found;
+	}
+
+	FParsedCategories& Parsed = ParsedCategories.Add(Value);
+	UE::String::ParseTokens(Value, TEXT(','), [&](FStringView Tag)
+	{
+		const FGameplayTag GameplayTag = FGameplayTag::RequestGameplayTag(FName(Tag), false);
+		if (GameplayTag.IsValid())
+		{
+			Parsed.Tags.AddTagFast(GameplayTag);
+		}
+		else
+		{
+			Parsed.MissingTags.Emplace(Tag);
+		}
+	}, UE::String::EParseTokensOptions::SkipEmpty | UE::String::EParseTokensOptions::Trim);
+	
+	return Parsed;
+}
+
+TOptional<FString> UNeatMetadataCollection_GameplayTagCategories::GetMissingCategoriesError(const FString& Value) const
+{
+	if (Value.IsEmpty())
+	{
+		return {};
+	}
+
+	const TArray<FString>& MissingTags = FindOrParseCategories(Value).MissingTags;
+	if (MissingTags.IsEmpty())
+	{
+		return {};
+	}
+	return FString::Printf(TEXT("Categories refers to tags that don't exist, and are ignored: %s."), *FString::Join(MissingTags, TEXT(", ")));
+}
+
+void UNeatMetadataCollection_GameplayTagCategories::OnGameplayTagTreeChanged()
+{
+	ParsedCategories.Reset();
+}
 #pragma endregion 
 
 #pragma region Units
@@ -193,6 +342,16 @@ void UNeatMetadataCollection_AssetBundles::ImportValueForProperty(const FPropert
 		Super::ImportValueForProperty(Property, Value);
 	}
 }
+
+TSharedPtr<SWidget> UNeatMetadataCollection_AssetBundles::CreateValueWidgetForProperty(const TSharedRef<IPropertyHandle>& InHandle)
+{
+	if (InHandle->GetProperty()->GetFName() == GET_MEMBER_NAME_CHECKED(ThisClass, AssetBundles))
+	{
+		return SNew(SNeatAssetBundleSelector, InHandle);
+	}
+	
+	return Super::CreateValueWidgetForProperty(InHandle);
+}
 #pragma endregion
 
 #pragma region Color
@@ -239,16 +398,86 @@ namespace
 		}
 		return true;
 	}
+
+	FText GetOptionsPreviewText(const UClass* InOwnerClass, const TSharedRef<IPropertyHandle>& InHandle, TFunctionRef<TOptional<FString>()> GetError)
+	{
+		FString FunctionName;
+		if (!InOwnerClass || InHandle->GetValue(FunctionName) != FPropertyAccess::Success || FunctionName.IsEmpty() || GetError())
+		{
+			return FText::GetEmpty();
+		}
+
+		using EState = FNeatOptionsFunctionCache::FPreview::EState;
+		const FNeatOptionsFunctionCache::FPreview& Preview = FNeatOptionsFunctionCache::Get().FindOrRequestPreview(InOwnerClass, FunctionName);
+		switch (Preview.State)
+		{
+		case EState::Pending:
+			return INVTEXT("Evaluating options...");
+		case EState::TooSlow:
+			return FText::Format(INVTEXT("Options not previewed, the function took {0} ms."), FText::AsNumber(FMath::RoundToInt(Preview.Duration * 1000.0)));
+		case EState::Failed:
+			return INVTEXT("Options could not be previewed.");
+		default:
+			break;
+		}
+
+		FString Options = FString::Join(Preview.FirstOptions, TEXT(", "));
+		if (Preview.NumOptions > Preview.FirstOptions.Num())
+		{
+			Options += TEXT(", ...");
+		}
+		return FText::Format(INVTEXT("{0} {0}|plural(one=option,other=options): {1}"), Preview.NumOptions, FText::FromString(Options));
+	}
 }
 
 TSharedPtr<SWidget> UNeatMetadataCollection_GetOptions::CreateValueWidgetForProperty(const TSharedRef<IPropertyHandle>& InHandle)
 {
 	if (InHandle->GetProperty()->GetFName() == GET_MEMBER_NAME_CHECKED(ThisClass, GetOptions))
 	{
-		return SNew(SNeatFunctionSelector, InHandle)
-		.FunctionFilter_Static(&GetOptionsFunctionFilter)
-		.AddNewFunction_UObject(this, &ThisClass::OnAddNewFunction)
-		.MemberClass(CurrentWrapper.GetProperty()->GetOwnerClass());
+		// Validation results are cached, so the error can be polled by the widget. The collection is shared by all
+		// properties, so hold on to the class of the property that this widget edits.
+		const TWeakObjectPtr<const UClass> OwnerClass = CurrentWrapper.GetProperty()->GetOwnerClass();
+		auto GetError = [OwnerClass, InHandle]() -> TOptional<FString>
+		{
+			FString FunctionName;
+			if (!OwnerClass.IsValid() || InHandle->GetValue(FunctionName) != FPropertyAccess::Success || FunctionName.IsEmpty())
+			{
+				return {};
+			}
+			return FNeatOptionsFunctionCache::Get().FindOrValidate(OwnerClass.Get(), FunctionName, [&]() { return ValidateOptionsFunctionUncached(OwnerClass.Get(), FunctionName); });
+		};
+		
+		return SNew(SVerticalBox)
+		+SVerticalBox::Slot()
+		.AutoHeight()
+		[
+			SNew(SNeatFunctionSelector, InHandle)
+			.FunctionFilter_Static(&GetOptionsFunctionFilter)
+			.AddNewFunction_UObject(this, &ThisClass::OnAddNewFunction)
+			.MemberClass(CurrentWrapper.GetProperty()->GetOwnerClass())
+		]
+		+SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(0.0f, 2.0f)
+		[
+			SNew(STextBlock)
+			.AutoWrapText(true)
+			.Font(IDetailLayoutBuilder::GetDetailFont())
+			.ColorAndOpacity(FStyleColors::Error)
+			.Text_Lambda([GetError]() { const TOptional<FString> Error = GetError(); return Error ? FText::FromString(*Error) : FText(); })
+			.Visibility_Lambda([GetError]() { return GetError() ? EVisibility::Visible : EVisibility::Collapsed; })
+		]
+		+SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(0.0f, 2.0f)
+		[
+			SNew(STextBlock)
+			.AutoWrapText(true)
+			.Font(IDetailLayoutBuilder::GetDetailFontItalic())
+			.ColorAndOpacity(FSlateColor::UseSubduedForeground())
+			.Text_Lambda([OwnerClass, InHandle, GetError]() { return GetOptionsPreviewText(OwnerClass.Get(), InHandle, GetError); })
+			.Visibility_Lambda([]() { return GetDefault<UNeatMetadataUserSettings>()->bPreviewGetOptions ? EVisibility::Visible : EVisibility::Collapsed; })
+		];
 	}
 	
 	return Super::CreateValueWidgetForProperty(InHandle);
@@ -261,6 +490,18 @@ TOptional<FString> UNeatMetadataCollection_GetOptions::ValidateOptionsFunction(c
 		return NullOpt;
 	}
 	
+	const FProperty* EditedProperty = CurrentWrapper.GetProperty();
+	if (!ensure(EditedProperty))
+	{
+		return FString(TEXT("Internal Error!"));
+	}
+
+	const UClass* OwnerClass = EditedProperty->GetOwnerClass();
+	return FNeatOptionsFunctionCache::Get().FindOrValidate(OwnerClass, FunctionName, [&]() { return ValidateOptionsFunctionUncached(OwnerClass, FunctionName); });
+}
+
+TOptional<FString> UNeatMetadataCollection_GetOptions::ValidateOptionsFunctionUncached(const UClass* OwnerClass, const FString& FunctionName)
+{
 	const UFunction* Function;
 	if (FunctionName.Contains(TEXT(".")))
 	{
@@ -287,13 +528,12 @@ TOptional<FString> UNeatMetadataCollection_GetOptions::ValidateOptionsFunction(c
 	}
 	else
 	{
-		const FProperty* EditedProperty = CurrentWrapper.GetProperty();
-		if (!ensure(EditedProperty))
+		if (!ensure(OwnerClass))
 		{
 			return FString(TEXT("Internal Error!"));
 		}
 		
-		Function = EditedProperty->GetOwnerClass()->FindFunctionByName(FName(FunctionName));
+		Function = OwnerClass->FindFunctionByName(FName(FunctionName));
 	}
 
 	if (!Function)
@@ -327,7 +567,7 @@ TOptional<FString> UNeatMetadataCollection_GetOptions::ExportValueForProperty(FP
 	{
 		if (TOptional<FString> ErrorString = ValidateOptionsFunction(GetOptions))
 		{
-			// TODO: Figure out how to log this inside the Blueprint editor...
+			// The error is also displayed below the value widget.
 			UE_LOG(LogNeatMetadata, Error, TEXT("GetOptions[%s]: %s"), *CurrentWrapper.GetProperty()->GetName(), *ErrorString.GetValue());
 			return {};
 		}
@@ -338,8 +578,7 @@ TOptional<FString> UNeatMetadataCollection_GetOptions::ExportValueForProperty(FP
 
 bool UNeatMetadataCollection_GetOptions::IsRelevantForContainedProperty(const FProperty& InProperty) const
 {
-	bIsString = InProperty.IsA<FStrProperty>();
-	return bIsString || InProperty.IsA<FNameProperty>();
+	return InProperty.IsA<FStrProperty>() || InProperty.IsA<FNameProperty>();
 }
 
 TOptional<FString> UNeatMetadataCollection_GetOptions::OnAddNewFunction() const
@@ -356,6 +595,8 @@ TOptional<FString> UNeatMetadataCollection_GetOptions::OnAddNewFunction() const
 
 	static const UFunction* StringFunc = StaticClass()->FindFunctionByName(GET_FUNCTION_NAME_CHECKED(ThisClass, GetOptionsStringSignature));
 	static const UFunction* NameFunc = StaticClass()->FindFunctionByName(GET_FUNCTION_NAME_CHECKED(ThisClass, GetOptionsNameSignature));
+	// Decides whether or not the new function will return names or strings.
+	const bool bIsString = GetContainedProperty(*CurrentWrapper.GetProperty())->IsA<FStrProperty>();
 	FBlueprintEditorUtils::AddFunctionGraph(BP, NewGraph, true, bIsString ? StringFunc : NameFunc);
 
 	{
@@ -366,6 +607,14 @@ TOptional<FString> UNeatMetadataCollection_GetOptions::OnAddNewFunction() const
 
 	return UniqueName.ToString();
 }
+
+void UNeatMetadataCollection_GetOptions::ValidateMetadata(FNeatMetadataValidationContext& Context) const
+{
+	if (TOptional<FString> ErrorString = ValidateOptionsFunction(GetOptions))
+	{
+		Context.AddError(MoveTemp(ErrorString.GetValue()));
+	}
+}
 #pragma endregion
 
 #pragma region Directory Path
@@ -555,6 +804,26 @@ bool UNeatMetadataCollection_Numbers::IsPropertyVisible(const FProperty& Propert
 	
 	return true;
 }
+
+bool UNeatMetadataCollection_Numbers::IsPropertyVisibilityDynamic(const FProperty& Property) const
+{
+	static const FName ArrayClampName(GET_MEMBER_NAME_CHECKED(ThisClass, ArrayClamp));
+	static const FName MultipleName(GET_MEMBER_NAME_CHECKED(ThisClass, Multiple));
+	return Property.GetFName() == ArrayClampName || Property.GetFName() == MultipleName;
+}
+
+void UNeatMetadataCollection_Numbers::ValidateMetadata(FNeatMetadataValidationContext& Context) const
+{
+	if (ArrayClamp.IsEmpty() || ArrayClamp == TEXT("None") || !CurrentWrapper.IsValid())
+	{
+		return;
+	}
+
+	if (!FindFProperty<FArrayProperty>(CurrentWrapper.GetProperty()->GetOwnerClass(), FName(ArrayClamp)))
+	{
+		Context.AddError(FString::Printf(TEXT("ArrayClamp refers to %s, which is not an array variable."), *ArrayClamp));
+	}
+}
 #pragma endregion
 
 #pragma region AllowPreserveRatio
@@ -653,6 +922,105 @@ void UNeatMetadataCollection_Assets::ImportValueForProperty(const FProperty& Pro
 		Super::ImportValueForProperty(Property, Value);
 	}
 }
+
+TSharedPtr<SWidget> UNeatMetadataCollection_Assets::CreateFooterWidget()
+{
+	// The collection is shared by all properties and details panels, so the preview reads the metadata of the variable
+	// that it was created for, instead of the live values of this collection.
+	const FNeatMetadataWrapper Wrapper = CurrentWrapper;
+	return SNew(SNeatAssetFilterPreview)
+		.GetParams_Lambda([Wrapper]() { return MakeFilterQueryParams(Wrapper); });
+}
+
+FNeatAssetFilterQueryParams UNeatMetadataCollection_Assets::MakeFilterQueryParams(const FNeatMetadataWrapper& InWrapper)
+{
+	FNeatAssetFilterQueryParams Params;
+	if (!InWrapper.IsValid())
+	{
+		return Params;
+	}
+
+	// Class paths are parsed from the metadata, so that classes don't have to be loaded.
+	auto AddClasses = [&InWrapper](FName InKey, TArray<FTopLevelAssetPath>& OutClasses)
+	{
+		TArray<FString> ClassPaths;
+		InWrapper.GetMetadata(InKey).ParseIntoArray(ClassPaths, TEXT(","));
+		for (const FString& ClassPath : ClassPaths)
+		{
+			const FSoftObjectPath Path(ClassPath);
+			if (!Path.IsNull())
+			{
+				OutClasses.Add(Path.GetAssetPath());
+			}
+		}
+	};
+	AddClasses(GET_MEMBER_NAME_CHECKED(ThisClass, AllowedClasses), Params.AllowedClasses);
+	AddClasses(GET_MEMBER_NAME_CHECKED(ThisClass, DisallowedClasses), Params.DisallowedClasses);
+
+	// Without allowed classes, the picker shows assets of the class of the property. Interfaces can't be expressed as a
+	// class filter, so those aren't previewed.
+	if (Params.AllowedClasses.IsEmpty())
+	{
+		const FProperty* Property = InWrapper.GetProperty();
+		if (const FArrayProperty* AsArray = CastField<FArrayProperty>(Property))
+		{
+			Property = AsArray->Inner;
+		}
+		else if (const FSetProperty* AsSet = CastField<FSetProperty>(Property))
+		{
+			Property = AsSet->ElementProp;
+		}
+		else if (const FMapProperty* AsMap = CastField<FMapProperty>(Property))
+		{
+			Property = AsMap->GetValueProperty()->IsA<FObjectPropertyBase>() ? AsMap->GetValueProperty() : AsMap->GetKeyProperty();
+		}
+
+		const FObjectPropertyBase* AsObject = CastField<FObjectPropertyBase>(Property);
+		if (AsObject && AsObject->PropertyClass)
+		{
+			Params.AllowedClasses.Add(AsObject->PropertyClass->GetClassPathName());
+		}
+	}
+
+	// Tags are written by ExportValueForProperty as "Key=Value" or just "Key", separated by commas.
+	auto AddTags = [&InWrapper](FName InKey, TArray<TPair<FName, FString>>& OutTags)
+	{
+		TArray<FString> Tags;
+		InWrapper.GetMetadata(InKey).ParseIntoArray(Tags, TEXT(","));
+		for (const FString& Tag : Tags)
+		{
+			FString Key = Tag;
+			FString Value;
+			Tag.Split(TEXT("="), &Key, &Value);
+			if (!Key.IsEmpty())
+			{
+				OutTags.Emplace(FName(Key), Value);
+			}
+		}
+	};
+	AddTags(TEXT("RequiredAssetDataTags"), Params.RequiredTags);
+	AddTags(TEXT("DisallowedAssetDataTags"), Params.DisallowedTags);
+
+	return Params;
+}
+
+void UNeatMetadataCollection_Assets::ValidateMetadata(FNeatMetadataValidationContext& Context) const
+{
+	for (const TSoftClassPtr<UObject>& Class : AllowedClasses)
+	{
+		if (!Class.IsNull())
+		{
+			Context.AddAssetReference(Class.ToSoftObjectPath(), TEXT("AllowedClasses"));
+		}
+	}
+	for (const TSoftClassPtr<UObject>& Class : DisallowedClasses)
+	{
+		if (!Class.IsNull())
+		{
+			Context.AddAssetReference(Class.ToSoftObjectPath(), TEXT("DisallowedClasses"));
+		}
+	}
+}
 #pragma endregion
 
 #pragma region Row Type
@@ -663,19 +1031,29 @@ UNeatMetadataCollection_RowType::UNeatMetadataCollection_RowType()
 
 TArray<FString> UNeatMetadataCollection_RowType::GetPossibleRowTypes()
 {
-	TArray<FAssetData> Assets;
-	FDataTableEditorUtils::GetPossibleStructAssetData(Assets);
+	const TConstArrayView<FNeatRowStructCatalog::FEntry> Entries = FNeatRowStructCatalog::Get().GetEntries();
 	
 	TArray<FString> Rows;
+	Rows.Reserve(Entries.Num() + 1);
 	Rows.Add("None");
-	for (const FAssetData& Asset : Assets)
+	for (const FNeatRowStructCatalog::FEntry& Entry : Entries)
 	{
-		Rows.Add(Asset.GetSoftObjectPath().GetAssetPathString());
+		Rows.Add(Entry.Path);
 	}
 
 	return Rows;
 }
 
+TSharedPtr<SWidget> UNeatMetadataCollection_RowType::CreateValueWidgetForProperty(const TSharedRef<IPropertyHandle>& InHandle)
+{
+	if (InHandle->GetProperty()->GetFName() == GET_MEMBER_NAME_CHECKED(ThisClass, RowType))
+	{
+		return SNew(SNeatRowTypeSelector, InHandle);
+	}
+	
+	return Super::CreateValueWidgetForProperty(InHandle);
+}
+
 TOptional<FString> UNeatMetadataCollection_RowType::ExportValueForProperty(FProperty& Property) const
 {
 	if (Property.GetFName() == GET_MEMBER_NAME_CHECKED(ThisClass, RowType))
@@ -8,6 +8,8 @@
 #include "Math/UnitConversion.h"
 #include "NeatMetadataCollections.generated.h"
 
+struct FNeatAssetFilterQueryParams;
+
 /**
  * Controls what "Categories", or root gameplay tags can be selected on a GameplayTag
  * or GameplayTagContainer property. Use this if you only want specific tags to be selectable.
@@ -29,6 +31,26 @@ public:
 protected:
 	virtual TOptional<FString> ExportValueForProperty(FProperty& Property) const override;
 	virtual void ImportValueForProperty(const FProperty& Property, const FString& Value) override;
+	virtual TSharedPtr<SWidget> CreateFooterWidget() override;
+	virtual void ValidateMetadata(FNeatMetadataValidationContext& Context) const override;
+	virtual void PostInitProperties() override;
+	virtual void BeginDestroy() override;
+
+private:
+	struct FParsedCategories
+	{
+		FGameplayTagContainer Tags;
+		// Tags in the metadata that aren't gameplay tags. These are dropped from Tags.
+		TArray<FString> MissingTags;
+	};
+
+	const FParsedCategories& FindOrParseCategories(const FString& Value) const;
+	TOptional<FString> GetMissingCategoriesError(const FString& Value) const;
+	void OnGameplayTagTreeChanged();
+
+	// Parsed containers, keyed by the raw metadata string. Discarded whenever the tag tree changes.
+	mutable TMap<FString, FParsedCategories> ParsedCategories;
+	FDelegateHandle TagTreeChangedHandle;
 };
 
 
@@ -73,6 +95,8 @@ public:
 
 protected:
 	virtual bool IsPropertyVisible(const FProperty& Property) const override;
+	virtual bool IsPropertyVisibilityDynamic(const FProperty& Property) const override;
+	virtual void ValidateMetadata(FNeatMetadataValidationContext& Context) const override;
 };
 
 
@@ -152,6 +176,7 @@ protected:
 	virtual bool IsRelevantForContainedProperty(const FProperty& InProperty) const override;
 	virtual TOptional<FString> ExportValueForProperty(FProperty& Property) const override;
 	virtual void ImportValueForProperty(const FProperty& Property, const FString& Value) override;
+	virtual TSharedPtr<SWidget> CreateValueWidgetForProperty(const TSharedRef<IPropertyHandle>& InHandle) override;
 };
 
 
@@ -215,14 +240,14 @@ protected:
 	TOptional<FString> ValidateOptionsFunction(const FString& FunctionName) const;
 	virtual TOptional<FString> ExportValueForProperty(FProperty& Property) const override;
 	virtual bool IsRelevantForContainedProperty(const FProperty& InProperty) const override;
+	virtual void ValidateMetadata(FNeatMetadataValidationContext& Context) const override;
 
 private:
-	// Decides whether or not the function generated by `AddNewFunction` will return names or strings.
-	// Mutable because the easiest place to check this is in `IsRelevantForContainedProperty`.
-	mutable bool bIsString = true;
-	
 	TOptional<FString> OnAddNewFunction() const;
 
+	// Validates a function without looking at the cache.
+	static TOptional<FString> ValidateOptionsFunctionUncached(const UClass* OwnerClass, const FString& FunctionName);
+
 	// Functions used to easily create new function graphs with the correct signature.
 	UFUNCTION() static TArray<FString> GetOptionsStringSignature() { return {}; }
 	UFUNCTION() static TArray<FName> GetOptionsNameSignature() { return {}; }
@@ -441,6 +466,8 @@ protected:
 	virtual TOptional<FString> ExportValueForProperty(FProperty& Property) const override;
 	virtual bool IsRelevantForContainedProperty(const FProperty& InProperty) const override;
 	virtual bool IsPropertyVisible(const FProperty& Property) const override;
+	virtual bool IsPropertyVisibilityDynamic(const FProperty& Property) const override;
+	virtual void ValidateMetadata(FNeatMetadataValidationContext& Context) const override;
 };
 
 
@@ -529,6 +556,12 @@ protected:
 	virtual bool IsRelevantForContainedProperty(const FProperty& InProperty) const override;
 	virtual TOptional<FString> ExportValueForProperty(FProperty& Property) const override;
 	virtual void ImportValueForProperty(const FProperty& Property, const FString& Value) override;;
+	virtual TSharedPtr<SWidget> CreateFooterWidget() override;
+	virtual void ValidateMetadata(FNeatMetadataValidationContext& Context) const override;
+
+private:
+	// The parts of the filter that the asset registry can evaluate, read from the metadata of a variable.
+	static FNeatAssetFilterQueryParams MakeFilterQueryParams(const FNeatMetadataWrapper& InWrapper);
 };
 
 
@@ -550,6 +583,7 @@ protected:
 	UFUNCTION()
 	static TArray<FString> GetPossibleRowTypes();
 	virtual TOptional<FString> ExportValueForProperty(FProperty& Property) const override;
+	virtual TSharedPtr<SWidget> CreateValueWidgetForProperty(const TSharedRef<IPropertyHandle>& InHandle) override;
 };
 
 
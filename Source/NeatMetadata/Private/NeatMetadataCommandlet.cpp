@@ -0,0 +1,323 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#include "NeatMetadataCommandlet.h"
+#include "NeatMetadataAssetTags.h"
+#include "NeatMetadataCollection.h"
+#include "NeatMetadataCollectionRegistry.h"
+#include "NeatMetadataModule.h"
+#include "NeatMetadataWrapper.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Blueprint.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "UObject/SavePackage.h"
+
+UNeatMetadataCommandlet::UNeatMetadataCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UNeatMetadataCommandlet::Main(const FString& Params)
+{
+	FString RulesFilename;
+	const bool bHasRules = FParse::Value(*Params, TEXT("Rules="), RulesFilename);
+	bResaveUntagged = FParse::Param(*Params, TEXT("ResaveUntagged"));
+	if (!bHasRules && !bResaveUntagged)
+	{
+		UE_LOG(LogNeatMetadata, Error, TEXT("Usage: -run=NeatMetadata [-Rules=<File.json>] [-ResaveUntagged] [-BatchSize=100] [-DryRun]"));
+		return 1;
+	}
+
+	int32 BatchSize = 100;
+	FParse::Value(*Params, TEXT("BatchSize="), BatchSize);
+	BatchSize = FMath::Max(BatchSize, 1);
+	const bool bDryRun = FParse::Param(*Params, TEXT("DryRun"));
+
+	if (bHasRules && !LoadRules(RulesFilename))
+	{
+		return 1;
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(AssetRegistryConstants::ModuleName).Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	// Only filter by path if every rule is restricted to some paths. Untagged Blueprints are resaved wherever they are.
+	FARFilter Filter;
+	Filter.ClassPaths.Add(UBlueprint::StaticClass()->GetClassPathName());
+	Filter.bRecursiveClasses = true;
+	Filter.bRecursivePaths = true;
+	if (!bResaveUntagged && !Rules.ContainsByPredicate([](const FRule& Rule) { return Rule.Paths.IsEmpty(); }))
+	{
+		for (const FRule& Rule : Rules)
+		{
+			for (const FString& Path : Rule.Paths)
+			{
+				Filter.PackagePaths.AddUnique(FName(Path));
+			}
+		}
+	}
+
+	TArray<FAssetData> Assets;
+	AssetRegistry.GetAssets(Filter, Assets);
+	if (!bHasRules)
+	{
+		// Without rules, only Blueprints that need the tag have to be loaded.
+		Assets.RemoveAll([](const FAssetData& Asset) { return FNeatMetadataAssetTags::IsTagged(Asset); });
+	}
+	Assets.Sort([](const FAssetData& A, const FAssetData& B) { return A.PackageName.LexicalLess(B.PackageName); });
+	UE_LOG(LogNeatMetadata, Display, TEXT("Processing %d Blueprints in batches of %d."), Assets.Num(), BatchSize);
+
+	for (int32 Start = 0; Start < Assets.Num(); Start += BatchSize)
+	{
+		const int32 Num = FMath::Min(BatchSize, Assets.Num() - Start);
+		ProcessBatch(TConstArrayView<FAssetData>(Assets).Slice(Start, Num), bDryRun);
+
+		// Nothing from the batch is referenced any more, so release it before loading the next one. The keep flags of an
+		// editor commandlet would keep every asset, since assets are RF_Standalone.
+		CollectGarbage(RF_NoFlags);
+		UE_LOG(LogNeatMetadata, Display, TEXT("Processed %d/%d Blueprints."), Start + Num, Assets.Num());
+	}
+
+	UE_LOG(LogNeatMetadata, Display, TEXT("Applied rules to %d variables in %d Blueprints, added the metadata tag to %d Blueprints, saved %d packages%s. %d errors."),
+		NumVariables, NumBlueprints, NumUntaggedBlueprints, NumSavedPackages, bDryRun ? TEXT(" (dry run)") : TEXT(""), NumErrors);
+	return NumErrors > 0 ? 1 : 0;
+}
+
+bool UNeatMetadataCommandlet::LoadRules(const FString& InFilename)
+{
+	FString Json;
+	if (!FFileHelper::LoadFileToString(Json, *InFilename))
+	{
+		UE_LOG(LogNeatMetadata, Error, TEXT("Couldn't read rule file '%s'."), *InFilename);
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> Root;
+	if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Json), Root) || !Root)
+	{
+		UE_LOG(LogNeatMetadata, Error, TEXT("Couldn't parse rule file '%s'."), *InFilename);
+		return false;
+	}
+
+	const TArray<TSharedPtr<FJsonValue>>* RuleValues;
+	if (!Root->TryGetArrayField(TEXT("Rules"), RuleValues))
+	{
+		UE_LOG(LogNeatMetadata, Error, TEXT("Rule file '%s' has no \"Rules\" array."), *InFilename);
+		return false;
+	}
+
+	bool bSuccess = true;
+	for (int32 Index = 0; Index < RuleValues->Num(); Index++)
+	{
+		const TSharedPtr<FJsonObject>* RuleObject;
+		if (!(*RuleValues)[Index]->TryGetObject(RuleObject))
+		{
+			UE_LOG(LogNeatMetadata, Error, TEXT("Rule %d isn't an object."), Index);
+			bSuccess = false;
+			continue;
+		}
+
+		FRule Rule;
+		(*RuleObject)->TryGetStringArrayField(TEXT("Paths"), Rule.Paths);
+		for (FString& Path : Rule.Paths)
+		{
+			// Package paths in asset registry filters have no trailing slash.
+			Path.RemoveFromEnd(TEXT("/"));
+		}
+		(*RuleObject)->TryGetStringField(TEXT("Variable"), Rule.Variable);
+
+		FString Type;
+		if ((*RuleObject)->TryGetStringField(TEXT("Type"), Type))
+		{
+			Rule.Type = FName(Type);
+		}
+
+		FString CollectionName;
+		if (!(*RuleObject)->TryGetStringField(TEXT("Collection"), CollectionName))
+		{
+			UE_LOG(LogNeatMetadata, Error, TEXT("Rule %d has no \"Collection\"."), Index);
+			bSuccess = false;
+			continue;
+		}
+
+		UClass* CollectionClass = FindCollectionClass(CollectionName);
+		if (!CollectionClass)
+		{
+			UE_LOG(LogNeatMetadata, Error, TEXT("Rule %d: '%s' isn't a metadata collection."), Index, *CollectionName);
+			bSuccess = false;
+			continue;
+		}
+
+		const TSharedPtr<FJsonObject>* Values;
+		if ((*RuleObject)->TryGetObjectField(TEXT("Values"), Values))
+		{
+			for (const TPair<FString, TSharedPtr<FJsonValue>>& Value : (*Values)->Values)
+			{
+				if (!FindFProperty<FProperty>(CollectionClass, FName(Value.Key)))
+				{
+					UE_LOG(LogNeatMetadata, Error, TEXT("Rule %d: '%s' has no property named '%s'."), Index, *CollectionName, *Value.Key);
+					bSuccess = false;
+					continue;
+				}
+				Rule.Values.Emplace(FName(Value.Key), Value.Value->AsString());
+			}
+		}
+
+		Rule.CollectionIndex = Collections.Add(NewObject<UNeatMetadataCollection>(this, CollectionClass));
+		Rules.Add(MoveTemp(Rule));
+	}
+
+	return bSuccess;
+}
+
+UClass* UNeatMetadataCommandlet::FindCollectionClass(const FString& InName)
+{
+	if (FPackageName::IsValidObjectPath(InName))
+	{
+		UClass* Class = LoadClass<UNeatMetadataCollection>(nullptr, *InName);
+		return FNeatMetadataCollectionRegistry::IsCollectionClass(Class) ? Class : nullptr;
+	}
+
+	// Native collections may be referred to without their prefix, e.g. "Units" for UNeatMetadataCollection_Units.
+	UClass* FoundClass = nullptr;
+	FNeatMetadataCollectionRegistry::Get().ForEachClass([&](UClass& Class)
+	{
+		const FString ClassName = Class.GetName();
+		if (!FoundClass && (ClassName == InName || ClassName == TEXT("NeatMetadataCollection_") + InName))
+		{
+			FoundClass = &Class;
+		}
+	});
+	return FoundClass;
+}
+
+void UNeatMetadataCommandlet::ProcessBatch(TConstArrayView<FAssetData> InAssets, bool bInDryRun)
+{
+	// Request the whole batch at once, so that the loader can work on the packages in parallel.
+	for (const FAssetData& Asset : InAssets)
+	{
+		LoadPackageAsync(Asset.PackageName.ToString(), FLoadPackageAsyncDelegate::CreateLambda([this](const FName& PackageName, UPackage* Package, EAsyncLoadingResult::Type Result)
+		{
+			if (Result != EAsyncLoadingResult::Succeeded || !Package)
+			{
+				UE_LOG(LogNeatMetadata, Error, TEXT("Couldn't load '%s'."), *PackageName.ToString());
+				NumErrors++;
+			}
+		}));
+	}
+	FlushAsyncLoading();
+
+	for (const FAssetData& Asset : InAssets)
+	{
+		UBlueprint* Blueprint = Cast<UBlueprint>(Asset.FastGetAsset(false));
+		if (!Blueprint)
+		{
+			continue;
+		}
+
+		const int32 NumChanged = ApplyRules(*Blueprint);
+		if (NumChanged > 0)
+		{
+			NumBlueprints++;
+			NumVariables += NumChanged;
+		}
+
+		// Saving writes the asset registry tag, so Blueprints saved before the plugin was enabled only have to be resaved.
+		const bool bNeedsTag = bResaveUntagged && !FNeatMetadataAssetTags::IsTagged(Asset);
+		NumUntaggedBlueprints += bNeedsTag ? 1 : 0;
+
+		// Writes only dirty the package if the metadata actually changed.
+		UPackage* Package = Blueprint->GetPackage();
+		if (bInDryRun || !(Package->IsDirty() || bNeedsTag))
+		{
+			continue;
+		}
+
+		const FString Filename = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension());
+		FSavePackageArgs SaveArgs;
+		SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+		SaveArgs.SaveFlags = SAVE_NoError;
+		if (UPackage::SavePackage(Package, nullptr, *Filename, SaveArgs))
+		{
+			NumSavedPackages++;
+		}
+		else
+		{
+			UE_LOG(LogNeatMetadata, Error, TEXT("Couldn't save '%s'."), *Filename);
+			NumErrors++;
+		}
+	}
+}
+
+int32 UNeatMetadataCommandlet::ApplyRules(UBlueprint& InBlueprint)
+{
+	const UClass* VariableClass = InBlueprint.SkeletonGeneratedClass ? InBlueprint.SkeletonGeneratedClass : InBlueprint.GeneratedClass;
+	if (!VariableClass)
+	{
+		return 0;
+	}
+
+	int32 NumChanged = 0;
+	for (const FBPVariableDescription& Variable : InBlueprint.NewVariables)
+	{
+		FProperty* Property = FindFProperty<FProperty>(VariableClass, Variable.VarName);
+		if (!Property)
+		{
+			continue;
+		}
+
+		bool bChanged = false;
+		for (const FRule& Rule : Rules)
+		{
+			UNeatMetadataCollection& Collection = *Collections[Rule.CollectionIndex];
+			if (!DoesRuleMatch(Rule, InBlueprint, Variable) || !Collection.IsRelevantForProperty(*Property))
+			{
+				continue;
+			}
+
+			const FNeatMetadataWrapper Wrapper(Property, &InBlueprint);
+			Collection.InitializeFromMetadata(Wrapper);
+			for (const TPair<FName, FString>& Value : Rule.Values)
+			{
+				if (!Collection.ApplyValue(Value.Key, Value.Value))
+				{
+					UE_LOG(LogNeatMetadata, Error, TEXT("%s.%s: Couldn't set '%s' to '%s'."), *InBlueprint.GetName(), *Variable.VarName.ToString(), *Value.Key.ToString(), *Value.Value);
+					NumErrors++;
+				}
+			}
+			bChanged = true;
+		}
+
+		NumChanged += bChanged ? 1 : 0;
+	}
+	return NumChanged;
+}
+
+bool UNeatMetadataCommandlet::DoesRuleMatch(const FRule& InRule, const UBlueprint& InBlueprint, const FBPVariableDescription& InVariable)
+{
+	if (!InRule.Paths.IsEmpty())
+	{
+		const FString PackageName = InBlueprint.GetPackage()->GetName();
+		const bool bIsInPaths = InRule.Paths.ContainsByPredicate([&](const FString& Path)
+		{
+			return PackageName.StartsWith(Path + TEXT("/"));
+		});
+		if (!bIsInPaths)
+		{
+			return false;
+		}
+	}
+
+	if (!InRule.Type.IsNone() && InVariable.VarType.PinCategory != InRule.Type)
+	{
+		return false;
+	}
+
+	return InVariable.VarName.ToString().MatchesWildcard(InRule.Variable);
+}
@@ -0,0 +1,81 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "NeatMetadataCommandlet.generated.h"
+
+class UBlueprint;
+class UNeatMetadataCollection;
+struct FAssetData;
+struct FBPVariableDescription;
+
+/**
+ * Applies metadata to Blueprint variables in bulk, without opening the editor.
+ *
+ * Usage: UnrealEditor-Cmd <Project> -run=NeatMetadata [-Rules=<File.json>] [-ResaveUntagged] [-BatchSize=100] [-DryRun]
+ *
+ * The rule file contains an array of rules. Each rule selects variables, and sets properties of a metadata collection
+ * on them. Values are written through the collection, exactly like when they are edited in the details panel:
+ *
+ * {
+ *     "Rules": [
+ *         {
+ *             "Paths": [ "/Game/Gameplay" ],
+ *             "Variable": "*Distance",
+ *             "Type": "real",
+ *             "Collection": "Units",
+ *             "Values": { "Units": "Centimeters" }
+ *         }
+ *     ]
+ * }
+ *
+ * "Paths" (package paths, recursive), "Variable" (a wildcard) and "Type" (a pin category) are optional. Variables are
+ * also only affected if the collection is relevant for them. Blueprints are loaded asynchronously in batches, only
+ * packages that were changed are saved, and garbage is collected between batches.
+ *
+ * -ResaveUntagged also resaves Blueprints that were saved before the plugin was enabled, which adds the asset registry
+ * tag that the reference index and bulk editor read. It can be used with or without rules. @see FNeatMetadataAssetTags.
+ */
+UCLASS()
+class UNeatMetadataCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UNeatMetadataCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	struct FRule
+	{
+		TArray<FString> Paths;
+		FString Variable = TEXT("*");
+		FName Type;
+		TArray<TPair<FName, FString>> Values;
+		// Index into Collections.
+		int32 CollectionIndex = INDEX_NONE;
+	};
+
+	bool LoadRules(const FString& InFilename);
+	static UClass* FindCollectionClass(const FString& InName);
+
+	void ProcessBatch(TConstArrayView<FAssetData> InAssets, bool bInDryRun);
+	int32 ApplyRules(UBlueprint& InBlueprint);
+	static bool DoesRuleMatch(const FRule& InRule, const UBlueprint& InBlueprint, const FBPVariableDescription& InVariable);
+
+	TArray<FRule> Rules;
+	bool bResaveUntagged = false;
+
+	// One instance per rule, kept alive between batches.
+	UPROPERTY()
+	TArray<TObjectPtr<UNeatMetadataCollection>> Collections;
+
+	int32 NumBlueprints = 0;
+	int32 NumVariables = 0;
+	int32 NumUntaggedBlueprints = 0;
+	int32 NumSavedPackages = 0;
+	int32 NumErrors = 0;
+};
@@ -12,6 +12,10 @@
 #include "Widgets/Input/SEditableText.h"
 #include "Widgets/Input/SEditableTextBox.h"
 #include "NeatMetadataWrapper.h"
+#include "NeatMetadataBatch.h"
+#include "NeatMetadataRowGeneratorCache.h"
+#include "IPropertyUtilities.h"
+#include "Containers/Ticker.h"
 
 #define LOCTEXT_NAMESPACE "NeatMetadataDetailCustomization"
 
@@ -42,6 +46,11 @@ FNeatMetadataDetailCustomization::FNeatMetadataDetailCustomization(UBlueprint* I
 {
 }
 
+FNeatMetadataDetailCustomization::~FNeatMetadataDetailCustomization()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(ExpansionTickerHandle);
+}
+
 void FNeatMetadataDetailCustomization::CustomizeDetails(IDetailLayoutBuilder& DetailLayout)
 {
 	TArray<TWeakObjectPtr<UObject>> ObjectsBeingCustomized;
@@ -75,92 +84,103 @@ void FNeatMetadataDetailCustomization::CustomizeDetails(IDetailLayoutBuilder& De
 		
 		IDetailCategoryBuilder& MetadataCategory = DetailLayout.EditCategory("Metadata", LOCTEXT("MetadataCategoryTitle", "Metadata"));
 
-		TMap<FName, IDetailGroup*> GroupNameToGroup;
+		// Gather collections per group first. Groups (and collections without a group) are added in the order they were first seen.
+		struct FGroupEntry
+		{
+			FName Name;
+			const FString* GroupPtr = nullptr;
+			TArray<UNeatMetadataCollection*, TInlineAllocator<4>> Collections;
+		};
+		TArray<FGroupEntry> Groups;
+		TMap<FName, int32> GroupNameToIndex;
 		
-		GetDefault<UNeatMetadataSettings>()->ForEachCollection([&](UNeatMetadataCollection& Collection)
+		GetDefault<UNeatMetadataSettings>()->ForEachRelevantCollection(*PropertyBeingCustomized, [&](UNeatMetadataCollection& Collection)
 		{
-			if (!Collection.IsRelevantForProperty(*PropertyBeingCustomized))
+			const UClass& CollectionClass = *Collection.GetClass();
+			if (CollectionClass.HasMetaData(TEXT("NoGroup")))
 			{
+				Groups.AddDefaulted_GetRef().Collections.Add(&Collection);
 				return;
 			}
 
-			const UClass& CollectionClass = *Collection.GetClass();
-			const bool bNoGroup = CollectionClass.HasMetaData(TEXT("NoGroup"));
-			
-			IDetailGroup* Group = nullptr;
-
-			if (!bNoGroup)
+			const FString* GroupPtr = CollectionClass.FindMetaData(TEXT("Group"));
+			const FName GroupName = GroupPtr ? FName(*GroupPtr) : CollectionClass.GetFName();
+			if (const int32* FoundIndex = GroupNameToIndex.Find(GroupName))
 			{
-				const FString* GroupPtr = CollectionClass.FindMetaData(TEXT("Group"));
-				const FName GroupName = GroupPtr ? FName(*GroupPtr) : CollectionClass.GetFName();
-				if (IDetailGroup** FoundGroup = GroupNameToGroup.Find(GroupName))
-				{
-					Group = *FoundGroup;
-				}
+				Groups[*FoundIndex].Collections.Add(&Collection);
+				return;
+			}
 
-				if (!Group)
-				{
-					const FText GroupDisplayName = GroupPtr ? FText::FromString(*GroupPtr) : CollectionClass.GetDisplayNameText();
-					Group = &MetadataCategory.AddGroup(GroupName, GroupDisplayName);
+			GroupNameToIndex.Add(GroupName, Groups.Num());
+			FGroupEntry& Entry = Groups.AddDefaulted_GetRef();
+			Entry.Name = GroupName;
+			Entry.GroupPtr = GroupPtr;
+			Entry.Collections.Add(&Collection);
+		});
 
-					FText Tooltip = GroupPtr ? FText() : CollectionClass.GetToolTipText();
-					if (GroupPtr)
-					{
-						if (const FText* FoundTooltip = GetDefault<UNeatMetadataSettings>()->GroupTooltips.Find(GroupName))
-						{
-							Tooltip = *FoundTooltip;
-						}
-					}
-					
-					// Customize the header to allow tooltips on the group itself.
-					Group->HeaderRow()
-					.NameContent()
-					[
-						SNew(STextBlock)
-						.ToolTipText(Tooltip)
-						.Font(DetailLayout.GetDetailFont())
-						.Text(GroupDisplayName)
-					];
+		const UNeatMetadataUserSettings* UserSettings = GetDefault<UNeatMetadataUserSettings>();
+		PropertyUtilities = DetailLayout.GetPropertyUtilities();
+		TrackedGroups.Reset();
+		for (const FGroupEntry& Entry : Groups)
+		{
+			if (Entry.Name.IsNone())
+			{
+				AddCollectionRows(MetadataCategory, nullptr, *Entry.Collections[0], MetaWrapper);
+				continue;
+			}
+
+			const UClass& FirstClass = *Entry.Collections[0]->GetClass();
+			const FText GroupDisplayName = Entry.GroupPtr ? FText::FromString(*Entry.GroupPtr) : FirstClass.GetDisplayNameText();
+			// Only groups that the user keeps expanded are populated. Importing metadata and creating rows for the others
+			// is deferred until they are expanded, at which point the details panel is refreshed.
+			const bool bPopulated = UserSettings->IsGroupExpanded(Entry.Name);
+			IDetailGroup& Group = MetadataCategory.AddGroup(Entry.Name, GroupDisplayName, false, bPopulated);
+			TrackedGroups.Add({ &Group, Entry.Name, bPopulated, bPopulated });
 
-					GroupNameToGroup.Add(GroupName, Group);
+			FText Tooltip = Entry.GroupPtr ? FText() : FirstClass.GetToolTipText();
+			if (Entry.GroupPtr)
+			{
+				if (const FText* FoundTooltip = GetDefault<UNeatMetadataSettings>()->GroupTooltips.Find(Entry.Name))
+				{
+					Tooltip = *FoundTooltip;
 				}
 			}
 
-			Collection.InitializeFromMetadata(MetaWrapper);
-
-			const FAddPropertyParams Params = FAddPropertyParams()
-				.UniqueId(FName(FString::Printf(TEXT("%s_%s"), *Blueprint->GetName(), *PropertyBeingCustomized->GetName())))
-				.HideRootObjectNode(true)
-				.CreateCategoryNodes(false);
+			// Customize the header to allow tooltips on the group itself.
+			Group.HeaderRow()
+			.NameContent()
+			[
+				SNew(STextBlock)
+				.ToolTipText(Tooltip)
+				.Font(DetailLayout.GetDetailFont())
+				.Text(GroupDisplayName)
+			];
 
-			IDetailPropertyRow* Row = MetadataCategory.AddExternalObjects({ &Collection }, EPropertyLocation::Default, Params);
-			check(Row && Row->GetPropertyHandle());
-			
-			// This seems incredibly dirty, but I haven't found a workaround.
-			// We want to add our collection so there are property handles for all properties, but we don't want to show any of them by default.
-			// That's how we can show/hide properties depending on the state of a collection.
-			Row->Visibility(EVisibility::Collapsed);
-			
-			Collection.ForEachVisibleProperty([&](const FProperty& Property)
+			if (bPopulated)
 			{
-				if (const TSharedPtr<IPropertyHandle> Handle = Row->GetPropertyHandle()->GetChildHandle(Property.GetFName()))
+				for (UNeatMetadataCollection* Collection : Entry.Collections)
 				{
-					IDetailPropertyRow& CreatedRow = Group ? Group->AddPropertyRow(Handle.ToSharedRef()) : MetadataCategory.AddProperty(Handle);
-					if (const TSharedPtr<SWidget> ValueWidget = Collection.CreateValueWidgetForProperty(Handle.ToSharedRef()))
-					{
-						CreatedRow.CustomWidget()
-						.NameContent()
-						[
-							Handle->CreatePropertyNameWidget()
-						]
-						.ValueContent()
-						[
-							ValueWidget.ToSharedRef()
-						];
-					}
+					AddCollectionRows(MetadataCategory, &Group, *Collection, MetaWrapper);
 				}
-			});
-		});
+			}
+			else
+			{
+				// Groups without children can't be expanded, so add a cheap placeholder row.
+				Group.AddWidgetRow()
+				.WholeRowContent()
+				[
+					SNew(STextBlock)
+					.Font(DetailLayout.GetDetailFontItalic())
+					.Text(LOCTEXT("CollapsedGroupPlaceholder", "Loading..."))
+				];
+			}
+		}
+
+		// Detail groups don't notify when they are expanded or collapsed, so their state is polled outside of painting.
+		if (!TrackedGroups.IsEmpty() && !ExpansionTickerHandle.IsValid())
+		{
+			ExpansionTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FNeatMetadataDetailCustomization::TickGroupExpansion), 0.1f);
+		}
 		
 		if (!PropertyBeingCustomized->GetMetaDataMap() || !GetDefault<UNeatMetadataUserSettings>()->bShowAllMetadataCategory)
 			return;
@@ -186,6 +206,7 @@ void FNeatMetadataDetailCustomization::CustomizeDetails(IDetailLayoutBuilder& De
 					MetaWrapper.GetProperty()->GetDisplayNameText()
 				);
 				FScopedTransaction Transaction(Desc);
+				FNeatMetadataBatch Batch;
 				
 				TArray<FName> MetadataNames;
 				MetaWrapper.GetProperty()->GetMetaDataMap()->GenerateKeyArray(MetadataNames);
@@ -256,4 +277,71 @@ void FNeatMetadataDetailCustomization::CustomizeDetails(IDetailLayoutBuilder& De
 	}
 }
 
+void FNeatMetadataDetailCustomization::AddCollectionRows(IDetailCategoryBuilder& Category, IDetailGroup* Group, UNeatMetadataCollection& Collection, const FNeatMetadataWrapper& MetaWrapper) const
+{
+	Collection.InitializeFromMetadata(MetaWrapper);
+
+	// Handles come from a row generator that lives as long as the collection does, so the property node tree of each
+	// collection is only built once. Which properties are shown depends on the state of the collection.
+	FNeatMetadataRowGeneratorCache& RowGenerators = FNeatMetadataRowGeneratorCache::Get();
+	RowGenerators.RefreshValues(Collection);
+	
+	Collection.ForEachVisibleProperty([&](const FProperty& Property)
+	{
+		if (const TSharedPtr<IPropertyHandle> Handle = RowGenerators.FindHandle(Collection, Property.GetFName()))
+		{
+			IDetailPropertyRow& CreatedRow = Group ? Group->AddPropertyRow(Handle.ToSharedRef()) : Category.AddProperty(Handle);
+			if (const TSharedPtr<SWidget> ValueWidget = Collection.CreateValueWidgetForProperty(Handle.ToSharedRef()))
+			{
+				CreatedRow.CustomWidget()
+				.NameContent()
+				[
+					Handle->CreatePropertyNameWidget()
+				]
+				.ValueContent()
+				[
+					ValueWidget.ToSharedRef()
+				];
+			}
+		}
+	});
+
+	if (const TSharedPtr<SWidget> FooterWidget = Collection.CreateFooterWidget())
+	{
+		FDetailWidgetRow& FooterRow = Group ? Group->AddWidgetRow() : Category.AddCustomRow(Collection.GetClass()->GetDisplayNameText());
+		FooterRow.WholeRowContent()
+		[
+			FooterWidget.ToSharedRef()
+		];
+	}
+}
+
+bool FNeatMetadataDetailCustomization::TickGroupExpansion(float DeltaTime)
+{
+	bool bNeedsRefresh = false;
+	for (FTrackedGroup& Tracked : TrackedGroups)
+	{
+		const bool bExpanded = Tracked.Group->GetExpansionState();
+		if (bExpanded == Tracked.bWasExpanded)
+		{
+			continue;
+		}
+
+		Tracked.bWasExpanded = bExpanded;
+		GetMutableDefault<UNeatMetadataUserSettings>()->SetGroupExpanded(Tracked.Name, bExpanded);
+		bNeedsRefresh = bNeedsRefresh || (bExpanded && !Tracked.bPopulated);
+	}
+
+	if (bNeedsRefresh)
+	{
+		if (const TSharedPtr<IPropertyUtilities> Utilities = PropertyUtilities.Pin())
+		{
+			// Refreshing destroys this customization, so nothing may be accessed afterwards.
+			Utilities->ForceRefresh();
+			return false;
+		}
+	}
+	return true;
+}
+
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,307 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#include "NeatMetadataLint.h"
+#include "NeatMetadataCollection.h"
+#include "NeatMetadataCollectionRegistry.h"
+#include "NeatMetadataModule.h"
+#include "NeatMetadataWrapper.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Algo/Transform.h"
+#include "Async/ParallelFor.h"
+#include "Engine/Blueprint.h"
+#include "Framework/Notifications/NotificationManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopedSlowTask.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "ToolMenus.h"
+#include "Widgets/Notifications/SNotificationList.h"
+
+namespace
+{
+	const FName MenuOwner("NeatMetadataLint");
+
+	FAutoConsoleCommand LintCommand(
+		TEXT("NeatMetadata.Lint"),
+		TEXT("Validates the metadata of all Blueprint variables and writes a report. Optionally takes package paths to limit the search to."),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&FNeatMetadataLint::RunInEditor)
+	);
+}
+
+void FNeatMetadataLint::RunInEditor(const TArray<FString>& InPaths)
+{
+	FNeatMetadataLint Lint(InPaths, 100);
+	Lint.Run();
+
+	const FString ReportFilename = FNeatMetadataLint::GetDefaultReportFilename();
+	Lint.WriteReport(ReportFilename);
+	UE_LOG(LogNeatMetadata, Display, TEXT("Found %d issues in %d Blueprints. Report written to %s."), Lint.GetIssues().Num(), Lint.GetNumBlueprints(), *ReportFilename);
+
+	FNotificationInfo Info(FText::Format(INVTEXT("Found {0} {0}|plural(one=issue,other=issues) in {1} {1}|plural(one=Blueprint,other=Blueprints)."), Lint.GetIssues().Num(), Lint.GetNumBlueprints()));
+	Info.ExpireDuration = 8.0f;
+	Info.Hyperlink = FSimpleDelegate::CreateLambda([ReportFilename]() { FPlatformProcess::LaunchFileInDefaultExternalApplication(*ReportFilename); });
+	Info.HyperlinkText = INVTEXT("Open Report");
+	FSlateNotificationManager::Get().AddNotification(Info);
+}
+
+void FNeatMetadataLint::RegisterMenus()
+{
+	UToolMenus::RegisterStartupCallback(FSimpleMulticastDelegate::FDelegate::CreateLambda([]()
+	{
+		FToolMenuOwnerScoped OwnerScoped(MenuOwner);
+		UToolMenu* Menu = UToolMenus::Get()->ExtendMenu("LevelEditor.MainMenu.Tools");
+		FToolMenuSection& Section = Menu->FindOrAddSection("NeatMetadata");
+		Section.AddMenuEntry(
+			"LintBlueprintMetadata",
+			INVTEXT("Lint Blueprint Metadata"),
+			INVTEXT("Validates the metadata of all Blueprint variables in the project, and writes a report. Same as the NeatMetadata.Lint console command."),
+			FSlateIcon(),
+			FUIAction(FExecuteAction::CreateLambda([]() { RunInEditor({}); }))
+		);
+	}));
+}
+
+void FNeatMetadataLint::UnregisterMenus()
+{
+	if (UObjectInitialized())
+	{
+		UToolMenus::UnRegisterStartupCallback(MenuOwner);
+		UToolMenus::UnregisterOwner(MenuOwner);
+	}
+}
+
+FNeatMetadataLint::FNeatMetadataLint(TArray<FString> InPaths, int32 InBatchSize)
+	: Paths(MoveTemp(InPaths))
+	, BatchSize(FMath::Max(InBatchSize, 1))
+{
+	FNeatMetadataCollectionRegistry::Get().ForEachClass([this](UClass& Class)
+	{
+		Collections.Emplace(NewObject<UNeatMetadataCollection>(GetTransientPackage(), &Class));
+	});
+}
+
+void FNeatMetadataLint::Run()
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(AssetRegistryConstants::ModuleName).Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	FARFilter Filter;
+	Filter.ClassPaths.Add(UBlueprint::StaticClass()->GetClassPathName());
+	Filter.bRecursiveClasses = true;
+	Filter.bRecursivePaths = true;
+	Algo::Transform(Paths, Filter.PackagePaths, [](const FString& Path) { return FName(Path); });
+
+	TArray<FAssetData> Assets;
+	AssetRegistry.GetAssets(Filter, Assets);
+	Assets.Sort([](const FAssetData& A, const FAssetData& B) { return A.PackageName.LexicalLess(B.PackageName); });
+	UE_LOG(LogNeatMetadata, Display, TEXT("Linting %d Blueprints in batches of %d."), Assets.Num(), BatchSize);
+
+	FScopedSlowTask SlowTask(Assets.Num() + 1, INVTEXT("Linting Blueprint metadata..."));
+	SlowTask.MakeDialog(true);
+
+	for (int32 Start = 0; Start < Assets.Num() && !SlowTask.ShouldCancel(); Start += BatchSize)
+	{
+		const int32 Num = FMath::Min(BatchSize, Assets.Num() - Start);
+		SlowTask.EnterProgressFrame(Num);
+		LintBatch(TConstArrayView<FAssetData>(Assets).Slice(Start, Num));
+
+		// Nothing from the batch is referenced any more, so release it before loading the next one. The keep flags of the
+		// editor would keep every asset alive, since assets are RF_Standalone. In the editor, LintBatch has already made the
+		// packages it loaded collectable, and everything else the user has loaded has to be kept.
+		CollectGarbage(IsRunningCommandlet() ? RF_NoFlags : GARBAGE_COLLECTION_KEEPFLAGS);
+		UE_LOG(LogNeatMetadata, Display, TEXT("Linted %d/%d Blueprints."), Start + Num, Assets.Num());
+	}
+
+	SlowTask.EnterProgressFrame(1, INVTEXT("Resolving asset references..."));
+	ResolveAssetReferences();
+
+	for (const FIssue& Issue : Issues)
+	{
+		UE_LOG(LogNeatMetadata, Error, TEXT("%s.%s [%s]: %s"), *Issue.Blueprint, *Issue.Variable.ToString(), *Issue.Collection, *Issue.Message);
+	}
+}
+
+void FNeatMetadataLint::LintBatch(TConstArrayView<FAssetData> InAssets)
+{
+	// Request the whole batch at once, so that the loader can work on the packages in parallel.
+	TArray<FName> LoadedPackages;
+	for (const FAssetData& Asset : InAssets)
+	{
+		if (!FindPackage(nullptr, *Asset.PackageName.ToString()))
+		{
+			LoadedPackages.Add(Asset.PackageName);
+		}
+		LoadPackageAsync(Asset.PackageName.ToString(), FLoadPackageAsyncDelegate::CreateLambda([this, ObjectPath = Asset.GetObjectPathString()](const FName& PackageName, UPackage* Package, EAsyncLoadingResult::Type Result)
+		{
+			if (Result != EAsyncLoadingResult::Succeeded || !Package)
+			{
+				Issues.Add({ ObjectPath, NAME_None, FString(), TEXT("Couldn't load the Blueprint.") });
+			}
+		}));
+	}
+	FlushAsyncLoading();
+
+	for (const FAssetData& Asset : InAssets)
+	{
+		if (UBlueprint* Blueprint = Cast<UBlueprint>(Asset.FastGetAsset(false)))
+		{
+			LintBlueprint(*Blueprint);
+		}
+	}
+
+	// Packages that weren't loaded before the lint can be collected once it's done with them, unless they were modified.
+	for (const FName PackageName : LoadedPackages)
+	{
+		UPackage* Package = FindPackage(nullptr, *PackageName.ToString());
+		if (Package && !Package->IsDirty())
+		{
+			ForEachObjectWithPackage(Package, [](UObject* Object)
+			{
+				Object->ClearFlags(RF_Standalone);
+				return true;
+			});
+		}
+	}
+}
+
+void FNeatMetadataLint::LintBlueprint(UBlueprint& InBlueprint)
+{
+	const UClass* VariableClass = InBlueprint.SkeletonGeneratedClass ? InBlueprint.SkeletonGeneratedClass : InBlueprint.GeneratedClass;
+	if (!VariableClass)
+	{
+		return;
+	}
+
+	NumBlueprints++;
+	const FString BlueprintPath = InBlueprint.GetPathName();
+
+	for (const FBPVariableDescription& Variable : InBlueprint.NewVariables)
+	{
+		FProperty* Property = FindFProperty<FProperty>(VariableClass, Variable.VarName);
+		if (!Property)
+		{
+			continue;
+		}
+
+		NumVariables++;
+		const FNeatMetadataWrapper Wrapper(Property, &InBlueprint);
+		for (const TStrongObjectPtr<UNeatMetadataCollection>& Collection : Collections)
+		{
+			if (!Collection->IsRelevantForProperty(*Property))
+			{
+				continue;
+			}
+
+			FNeatMetadataValidationContext Context;
+			Collection->InitializeFromMetadata(Wrapper);
+			Collection->ValidateMetadata(Context);
+
+			const FString CollectionName = Collection->GetClass()->GetName();
+			for (FString& Error : Context.Errors)
+			{
+				Issues.Add({ BlueprintPath, Variable.VarName, CollectionName, MoveTemp(Error) });
+			}
+			for (TPair<FSoftObjectPath, FString>& Reference : Context.AssetReferences)
+			{
+				FString Message = FString::Printf(TEXT("%s refers to %s, which doesn't exist."), *Reference.Value, *Reference.Key.ToString());
+				AssetReferences.Add({ Reference.Key, { BlueprintPath, Variable.VarName, CollectionName, MoveTemp(Message) } });
+			}
+		}
+	}
+}
+
+void FNeatMetadataLint::ResolveAssetReferences()
+{
+	// Many variables refer to the same assets, so each path is only resolved once.
+	TArray<FSoftObjectPath> UniquePaths;
+	TMap<FSoftObjectPath, int32> PathIndices;
+	PathIndices.Reserve(AssetReferences.Num());
+	for (const FAssetReference& Reference : AssetReferences)
+	{
+		if (!PathIndices.Contains(Reference.Path))
+		{
+			PathIndices.Add(Reference.Path, UniquePaths.Add(Reference.Path));
+		}
+	}
+
+	// Native classes are always loaded, but may only be looked up on the game thread. Everything else is resolved
+	// through the asset registry, which can be queried from any thread.
+	TArray<bool> Resolved;
+	Resolved.SetNumZeroed(UniquePaths.Num());
+	TArray<int32> AssetIndices;
+	for (int32 Index = 0; Index < UniquePaths.Num(); Index++)
+	{
+		if (FPackageName::IsScriptPackage(UniquePaths[Index].GetLongPackageName()))
+		{
+			Resolved[Index] = UniquePaths[Index].ResolveObject() != nullptr;
+		}
+		else
+		{
+			AssetIndices.Add(Index);
+		}
+	}
+
+	const IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	ParallelFor(AssetIndices.Num(), [&](int32 Index)
+	{
+		const FSoftObjectPath& Path = UniquePaths[AssetIndices[Index]];
+		TArray<FAssetData> Assets;
+		AssetRegistry.GetAssetsByPackageName(Path.GetLongPackageFName(), Assets, true);
+
+		// Blueprint classes aren't assets of their own, so `/Game/BP_Thing.BP_Thing_C` is resolved through `BP_Thing`.
+		const FString AssetName = Path.GetAssetName();
+		Resolved[AssetIndices[Index]] = Assets.ContainsByPredicate([&](const FAssetData& Asset)
+		{
+			const FString Name = Asset.AssetName.ToString();
+			return Name == AssetName || Name + TEXT("_C") == AssetName;
+		});
+	});
+
+	for (FAssetReference& Reference : AssetReferences)
+	{
+		if (!Resolved[PathIndices.FindChecked(Reference.Path)])
+		{
+			Issues.Add(MoveTemp(Reference.Issue));
+		}
+	}
+	AssetReferences.Empty();
+}
+
+bool FNeatMetadataLint::WriteReport(const FString& InFilename) const
+{
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("NumBlueprints"), NumBlueprints);
+	Writer->WriteValue(TEXT("NumVariables"), NumVariables);
+	Writer->WriteValue(TEXT("NumIssues"), Issues.Num());
+	Writer->WriteArrayStart(TEXT("Issues"));
+	for (const FIssue& Issue : Issues)
+	{
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("Blueprint"), Issue.Blueprint);
+		Writer->WriteValue(TEXT("Variable"), Issue.Variable.IsNone() ? FString() : Issue.Variable.ToString());
+		Writer->WriteValue(TEXT("Collection"), Issue.Collection);
+		Writer->WriteValue(TEXT("Message"), Issue.Message);
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteArrayEnd();
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	if (!FFileHelper::SaveStringToFile(Json, *InFilename))
+	{
+		UE_LOG(LogNeatMetadata, Error, TEXT("Couldn't write lint report to '%s'."), *InFilename);
+		return false;
+	}
+	return true;
+}
+
+FString FNeatMetadataLint::GetDefaultReportFilename()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("NeatMetadata"), TEXT("LintReport.json"));
+}
@@ -0,0 +1,87 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/StrongObjectPtr.h"
+
+class UBlueprint;
+class UNeatMetadataCollection;
+struct FAssetData;
+
+/**
+ * Validates the metadata of every Blueprint variable in the project, using UNeatMetadataCollection::ValidateMetadata.
+ * Blueprints are loaded asynchronously in batches, and asset references are resolved against the asset registry in
+ * parallel once all Blueprints have been visited.
+ *
+ * Used by UNeatMetadataLintCommandlet, the `NeatMetadata.Lint` console command and the Tools menu.
+ */
+class FNeatMetadataLint
+{
+public:
+	struct FIssue
+	{
+		// Object path of the Blueprint.
+		FString Blueprint;
+		FName Variable;
+		// Class name of the collection that found the problem. Empty if the Blueprint couldn't be checked at all.
+		FString Collection;
+		FString Message;
+	};
+
+	/**
+	 * @param InPaths Package paths to lint, recursively. Everything is linted if empty.
+	 * @param InBatchSize The number of Blueprints to load at once.
+	 */
+	FNeatMetadataLint(TArray<FString> InPaths, int32 InBatchSize);
+
+	/** @brief Loads and validates all Blueprints. Garbage is collected between batches. */
+	void Run();
+
+	/**
+	 * @brief Writes the issues as JSON.
+	 * @param InFilename The file to write to.
+	 * @return True if the file could be written.
+	 */
+	bool WriteReport(const FString& InFilename) const;
+
+	/** @return Where the report is written if nothing else is specified. */
+	static FString GetDefaultReportFilename();
+
+	/**
+	 * @brief Lints with a progress dialog, writes the report to the default location and shows a notification that links to it.
+	 * @param InPaths Package paths to lint, recursively. Everything is linted if empty.
+	 */
+	static void RunInEditor(const TArray<FString>& InPaths);
+
+	/** @brief Adds "Lint Blueprint Metadata" to the Tools menu of the level editor. */
+	static void RegisterMenus();
+	static void UnregisterMenus();
+
+	const TArray<FIssue>& GetIssues() const { return Issues; }
+	int32 GetNumBlueprints() const { return NumBlueprints; }
+	int32 GetNumVariables() const { return NumVariables; }
+
+private:
+	struct FAssetReference
+	{
+		FSoftObjectPath Path;
+		// The issue to report if the path can't be resolved.
+		FIssue Issue;
+	};
+
+	void LintBatch(TConstArrayView<FAssetData> InAssets);
+	void LintBlueprint(UBlueprint& InBlueprint);
+	void ResolveAssetReferences();
+
+	TArray<FString> Paths;
+	int32 BatchSize = 100;
+
+	// One instance per collection class, reused for all variables.
+	TArray<TStrongObjectPtr<UNeatMetadataCollection>> Collections;
+
+	TArray<FIssue> Issues;
+	TArray<FAssetReference> AssetReferences;
+	int32 NumBlueprints = 0;
+	int32 NumVariables = 0;
+};
@@ -0,0 +1,40 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#include "NeatMetadataLintCommandlet.h"
+#include "NeatMetadataLint.h"
+#include "NeatMetadataModule.h"
+
+UNeatMetadataLintCommandlet::UNeatMetadataLintCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UNeatMetadataLintCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Paths;
+	FString PathsString;
+	if (FParse::Value(*Params, TEXT("Paths="), PathsString))
+	{
+		PathsString.ParseIntoArray(Paths, TEXT("+"));
+	}
+
+	int32 BatchSize = 100;
+	FParse::Value(*Params, TEXT("BatchSize="), BatchSize);
+
+	FString ReportFilename = FNeatMetadataLint::GetDefaultReportFilename();
+	FParse::Value(*Params, TEXT("Report="), ReportFilename);
+
+	FNeatMetadataLint Lint(MoveTemp(Paths), BatchSize);
+	Lint.Run();
+
+	if (!Lint.WriteReport(ReportFilename))
+	{
+		return 1;
+	}
+
+	UE_LOG(LogNeatMetadata, Display, TEXT("Linted %d variables in %d Blueprints, found %d issues. Report written to %s."),
+		Lint.GetNumVariables(), Lint.GetNumBlueprints(), Lint.GetIssues().Num(), *ReportFilename);
+	return Lint.GetIssues().IsEmpty() ? 0 : 1;
+}
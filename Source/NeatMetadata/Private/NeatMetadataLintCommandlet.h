@@ -0,0 +1,27 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "NeatMetadataLintCommandlet.generated.h"
+
+/**
+ * Validates the metadata of all Blueprint variables, e.g. that GetOptions functions, EditCondition variables and
+ * AllowedClasses still exist. Intended to be run on CI.
+ *
+ * Usage: UnrealEditor-Cmd <Project> -run=NeatMetadataLint [-Paths=/Game/A+/Game/B] [-BatchSize=100] [-Report=<File.json>]
+ *
+ * The report defaults to Saved/NeatMetadata/LintReport.json, and the commandlet returns 1 if any issue was found.
+ * @see FNeatMetadataLint.
+ */
+UCLASS()
+class UNeatMetadataLintCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UNeatMetadataLintCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
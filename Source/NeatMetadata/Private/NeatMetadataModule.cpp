@@ -1,6 +1,18 @@
 // Copyright Viktor Pramberg. All Rights Reserved.
 #include "NeatMetadataModule.h"
 #include "NeatMetadataDetailCustomization.h"
+#include "NeatMetadataCollectionRegistry.h"
+#include "NeatMetadataVariableIndex.h"
+#include "NeatMetadataRowGeneratorCache.h"
+#include "NeatFunctionIndex.h"
+#include "NeatInterfaceCatalog.h"
+#include "NeatRowStructCatalog.h"
+#include "NeatOptionsFunctionCache.h"
+#include "NeatAssetBundleIndex.h"
+#include "NeatMetadataAssetTags.h"
+#include "NeatMetadataReferenceIndex.h"
+#include "NeatMetadataLint.h"
+#include "Widgets/SNeatMetadataBulkEditor.h"
 
 #include "BlueprintEditorModule.h"
 #include "Modules/ModuleManager.h"
@@ -14,6 +26,14 @@ public:
 	{
 		FBlueprintEditorModule& BlueprintEditorModule = FModuleManager::GetModuleChecked<FBlueprintEditorModule>("Kismet");
 		BlueprintVariableCustomizationHandle = BlueprintEditorModule.RegisterVariableCustomization(FProperty::StaticClass(), FOnGetVariableCustomizationInstance::CreateStatic(&FNeatMetadataDetailCustomization::MakeInstance));
+
+		FNeatMetadataAssetTags::Register();
+
+		// Created up front, since it has to be listening when a variable is renamed.
+		FNeatMetadataReferenceIndex::Get();
+
+		SNeatMetadataBulkEditor::RegisterTabSpawner();
+		FNeatMetadataLint::RegisterMenus();
 	}
 	
 	virtual void ShutdownModule() override
@@ -22,6 +42,19 @@ public:
 		{
 			BlueprintEditorModule->UnregisterVariableCustomization(FProperty::StaticClass(), BlueprintVariableCustomizationHandle);
 		}
+
+		FNeatMetadataLint::UnregisterMenus();
+		SNeatMetadataBulkEditor::UnregisterTabSpawner();
+		FNeatMetadataAssetTags::Unregister();
+		FNeatMetadataCollectionRegistry::TearDown();
+		FNeatMetadataVariableIndex::TearDown();
+		FNeatMetadataRowGeneratorCache::TearDown();
+		FNeatFunctionIndex::TearDown();
+		FNeatInterfaceCatalog::TearDown();
+		FNeatRowStructCatalog::TearDown();
+		FNeatOptionsFunctionCache::TearDown();
+		FNeatAssetBundleIndex::TearDown();
+		FNeatMetadataReferenceIndex::TearDown();
 	}
 
 private:
@@ -0,0 +1,461 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#include "NeatMetadataReferenceIndex.h"
+#include "NeatMetadataAssetTags.h"
+#include "NeatMetadataBatch.h"
+#include "NeatMetadataModule.h"
+#include "NeatMetadataVariableIndex.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/Blueprint.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+#include "ScopedTransaction.h"
+#include "UObject/ObjectSaveContext.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectHash.h"
+
+namespace
+{
+	const FName EditConditionName("EditCondition");
+	const FName ArrayClampName("ArrayClamp");
+	const FName GetOptionsName("GetOptions");
+	const FName TitlePropertyName("TitleProperty");
+
+	bool IsIdentifierStart(TCHAR InChar) { return FChar::IsAlpha(InChar) || InChar == TEXT('_'); }
+	bool IsIdentifierChar(TCHAR InChar) { return FChar::IsAlnum(InChar) || InChar == TEXT('_'); }
+
+	// Finds the identifiers in an edit condition expression. Identifiers that are part of `EnumType::Value` and literals
+	// are skipped, since those don't name properties.
+	template<typename FunctorType>
+	void ForEachIdentifier(FStringView InExpression, FunctorType&& Functor)
+	{
+		const int32 Length = InExpression.Len();
+		for (int32 Index = 0; Index < Length;)
+		{
+			if (FChar::IsDigit(InExpression[Index]))
+			{
+				// Numbers, including suffixes and decimals such as 0.5f.
+				while (Index < Length && (FChar::IsAlnum(InExpression[Index]) || InExpression[Index] == TEXT('.')))
+				{
+					Index++;
+				}
+				continue;
+			}
+
+			if (!IsIdentifierStart(InExpression[Index]))
+			{
+				Index++;
+				continue;
+			}
+
+			const int32 Start = Index;
+			while (Index < Length && IsIdentifierChar(InExpression[Index]))
+			{
+				Index++;
+			}
+
+			const bool bIsScoped = (Start >= 2 && InExpression[Start - 1] == TEXT(':') && InExpression[Start - 2] == TEXT(':'))
+				|| (Index + 1 < Length && InExpression[Index] == TEXT(':') && InExpression[Index + 1] == TEXT(':'));
+			const FStringView Identifier = InExpression.Mid(Start, Index - Start);
+			if (!bIsScoped && Identifier != TEXT("true") && Identifier != TEXT("false") && Identifier != TEXT("nullptr"))
+			{
+				Functor(Start, Index - Start);
+			}
+		}
+	}
+
+	FSoftObjectPath GetBlueprintPathFromClassPath(const FTopLevelAssetPath& InClassPath)
+	{
+		FString AssetName = InClassPath.GetAssetName().ToString();
+		AssetName.RemoveFromEnd(TEXT("_C"));
+		return FSoftObjectPath(FTopLevelAssetPath(InClassPath.GetPackageName(), FName(AssetName)));
+	}
+}
+
+TUniquePtr<FNeatMetadataReferenceIndex> FNeatMetadataReferenceIndex::Instance;
+
+FNeatMetadataReferenceIndex& FNeatMetadataReferenceIndex::Get()
+{
+	if (!Instance)
+	{
+		Instance = TUniquePtr<FNeatMetadataReferenceIndex>(new FNeatMetadataReferenceIndex());
+	}
+	return *Instance;
+}
+
+void FNeatMetadataReferenceIndex::TearDown()
+{
+	Instance.Reset();
+}
+
+FNeatMetadataReferenceIndex::FNeatMetadataReferenceIndex()
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(AssetRegistryConstants::ModuleName).Get();
+	AssetAddedHandle = AssetRegistry.OnAssetAdded().AddRaw(this, &FNeatMetadataReferenceIndex::OnAssetAddedOrUpdated);
+	AssetUpdatedHandle = AssetRegistry.OnAssetUpdated().AddRaw(this, &FNeatMetadataReferenceIndex::OnAssetAddedOrUpdated);
+	AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddRaw(this, &FNeatMetadataReferenceIndex::OnAssetRemoved);
+	AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddRaw(this, &FNeatMetadataReferenceIndex::OnAssetRenamed);
+
+	PackageSavedHandle = UPackage::PackageSavedWithContextEvent.AddRaw(this, &FNeatMetadataReferenceIndex::OnPackageSaved);
+	RenameVariableReferencesHandle = FBlueprintEditorUtils::OnRenameVariableReferencesEvent.AddRaw(this, &FNeatMetadataReferenceIndex::OnRenameVariableReferences);
+
+	if (AssetRegistry.IsLoadingAssets())
+	{
+		FilesLoadedHandle = AssetRegistry.OnFilesLoaded().AddRaw(this, &FNeatMetadataReferenceIndex::Build);
+	}
+	else
+	{
+		Build();
+	}
+}
+
+FNeatMetadataReferenceIndex::~FNeatMetadataReferenceIndex()
+{
+	if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>(AssetRegistryConstants::ModuleName))
+	{
+		AssetRegistryModule->Get().OnFilesLoaded().Remove(FilesLoadedHandle);
+		AssetRegistryModule->Get().OnAssetAdded().Remove(AssetAddedHandle);
+		AssetRegistryModule->Get().OnAssetUpdated().Remove(AssetUpdatedHandle);
+		AssetRegistryModule->Get().OnAssetRemoved().Remove(AssetRemovedHandle);
+		AssetRegistryModule->Get().OnAssetRenamed().Remove(AssetRenamedHandle);
+	}
+	UPackage::PackageSavedWithContextEvent.Remove(PackageSavedHandle);
+	FBlueprintEditorUtils::OnRenameVariableReferencesEvent.Remove(RenameVariableReferencesHandle);
+}
+
+void FNeatMetadataReferenceIndex::FindReferences(const FSymbol& InSymbol, TArray<FReference>& OutReferences) const
+{
+	if (const TArray<FReference>* Found = References.Find(InSymbol))
+	{
+		OutReferences.Append(*Found);
+	}
+}
+
+void FNeatMetadataReferenceIndex::ForEachSymbol(FName InScope, FName InKey, FStringView InValue, TFunctionRef<FForEachSymbolSignature> Functor)
+{
+	if (InValue.IsEmpty())
+	{
+		return;
+	}
+
+	auto MakeSymbol = [InValue](FName Scope, int32 Start, int32 Len, ESymbolKind Kind)
+	{
+		return FSymbol{ Scope, FName(InValue.Mid(Start, Len)), Kind };
+	};
+
+	if (InKey == EditConditionName)
+	{
+		ForEachIdentifier(InValue, [&](int32 Start, int32 Len)
+		{
+			Functor(MakeSymbol(InScope, Start, Len, ESymbolKind::Variable), Start, Len);
+		});
+	}
+	else if (InKey == ArrayClampName)
+	{
+		if (InValue != TEXT("None"))
+		{
+			Functor(MakeSymbol(InScope, 0, InValue.Len(), ESymbolKind::Variable), 0, InValue.Len());
+		}
+	}
+	else if (InKey == GetOptionsName)
+	{
+		// Static functions are written as `/Script/Module.Class.Function`.
+		int32 Dot = INDEX_NONE;
+		if (InValue.FindLastChar(TEXT('.'), Dot))
+		{
+			Functor(MakeSymbol(FName(InValue.Left(Dot)), Dot + 1, InValue.Len() - Dot - 1, ESymbolKind::Function), Dot + 1, InValue.Len() - Dot - 1);
+		}
+		else
+		{
+			Functor(MakeSymbol(InScope, 0, InValue.Len(), ESymbolKind::Function), 0, InValue.Len());
+		}
+	}
+	else if (InKey == TitlePropertyName)
+	{
+		// Either a single property, or a format like `{Name} - {Value}`.
+		int32 Open = INDEX_NONE;
+		if (!InValue.FindChar(TEXT('{'), Open))
+		{
+			Functor(MakeSymbol(NAME_None, 0, InValue.Len(), ESymbolKind::StructField), 0, InValue.Len());
+			return;
+		}
+
+		while (Open != INDEX_NONE)
+		{
+			int32 Close = INDEX_NONE;
+			if (!InValue.RightChop(Open + 1).FindChar(TEXT('}'), Close))
+			{
+				break;
+			}
+
+			if (Close > 0)
+			{
+				Functor(MakeSymbol(NAME_None, Open + 1, Close, ESymbolKind::StructField), Open + 1, Close);
+			}
+
+			const int32 Rest = Open + Close + 2;
+			int32 Next = INDEX_NONE;
+			Open = InValue.RightChop(Rest).FindChar(TEXT('{'), Next) ? Rest + Next : INDEX_NONE;
+		}
+	}
+}
+
+void FNeatMetadataReferenceIndex::Build()
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(AssetRegistryConstants::ModuleName).Get();
+	AssetRegistry.OnFilesLoaded().Remove(FilesLoadedHandle);
+
+	References.Reset();
+	SymbolsByBlueprint.Reset();
+
+	FARFilter Filter;
+	Filter.TagsAndValues.Add(FNeatMetadataAssetTags::TagName);
+
+	TArray<FNeatMetadataVariableSummary> Variables;
+	AssetRegistry.EnumerateAssets(Filter, [&](const FAssetData& AssetData)
+	{
+		Variables.Reset();
+		if (FNeatMetadataAssetTags::GetSummary(AssetData, Variables))
+		{
+			IndexBlueprint(AssetData.GetSoftObjectPath(), Variables);
+		}
+		return true;
+	});
+
+	bIsBuilt = true;
+}
+
+void FNeatMetadataReferenceIndex::IndexBlueprint(const FSoftObjectPath& InBlueprint, TConstArrayView<FNeatMetadataVariableSummary> InVariables)
+{
+	RemoveBlueprint(InBlueprint);
+
+	const FName Scope(InBlueprint.ToString());
+	TArray<FSymbol>* Symbols = nullptr;
+	for (const FNeatMetadataVariableSummary& Variable : InVariables)
+	{
+		for (const TPair<FName, FString>& Metadata : Variable.Metadata)
+		{
+			ForEachSymbol(Scope, Metadata.Key, Metadata.Value, [&](const FSymbol& Symbol, int32, int32)
+			{
+				References.FindOrAdd(Symbol).AddUnique({ InBlueprint, Variable.Variable, Metadata.Key });
+				if (!Symbols)
+				{
+					Symbols = &SymbolsByBlueprint.Add(InBlueprint);
+				}
+				Symbols->AddUnique(Symbol);
+			});
+		}
+	}
+}
+
+void FNeatMetadataReferenceIndex::IndexLoadedBlueprint(const UBlueprint& InBlueprint)
+{
+	TArray<FNeatMetadataVariableSummary> Variables;
+	FNeatMetadataAssetTags::Summarize(InBlueprint, Variables);
+	IndexBlueprint(FSoftObjectPath(&InBlueprint), Variables);
+}
+
+void FNeatMetadataReferenceIndex::RemoveBlueprint(const FSoftObjectPath& InBlueprint)
+{
+	TArray<FSymbol> Symbols;
+	if (!SymbolsByBlueprint.RemoveAndCopyValue(InBlueprint, Symbols))
+	{
+		return;
+	}
+
+	for (const FSymbol& Symbol : Symbols)
+	{
+		if (TArray<FReference>* SymbolReferences = References.Find(Symbol))
+		{
+			SymbolReferences->RemoveAll([&](const FReference& Reference) { return Reference.Blueprint == InBlueprint; });
+			if (SymbolReferences->IsEmpty())
+			{
+				References.Remove(Symbol);
+			}
+		}
+	}
+}
+
+void FNeatMetadataReferenceIndex::OnAssetAddedOrUpdated(const FAssetData& InAssetData)
+{
+	if (!bIsBuilt)
+	{
+		return;
+	}
+
+	TArray<FNeatMetadataVariableSummary> Variables;
+	if (FNeatMetadataAssetTags::GetSummary(InAssetData, Variables))
+	{
+		IndexBlueprint(InAssetData.GetSoftObjectPath(), Variables);
+	}
+	else
+	{
+		RemoveBlueprint(InAssetData.GetSoftObjectPath());
+	}
+}
+
+void FNeatMetadataReferenceIndex::OnAssetRemoved(const FAssetData& InAssetData)
+{
+	RemoveBlueprint(InAssetData.GetSoftObjectPath());
+}
+
+void FNeatMetadataReferenceIndex::OnAssetRenamed(const FAssetData& InAssetData, const FString& InOldObjectPath)
+{
+	RemoveBlueprint(FSoftObjectPath(InOldObjectPath));
+	OnAssetAddedOrUpdated(InAssetData);
+}
+
+void FNeatMetadataReferenceIndex::OnPackageSaved(const FString& InFilename, UPackage* InPackage, FObjectPostSaveContext InContext)
+{
+	// The asset registry isn't necessarily updated right away, but the tags are written from memory anyway.
+	ForEachObjectWithPackage(InPackage, [this](UObject* Object)
+	{
+		if (const UBlueprint* AsBlueprint = Cast<UBlueprint>(Object))
+		{
+			IndexLoadedBlueprint(*AsBlueprint);
+		}
+		return true;
+	}, false);
+}
+
+void FNeatMetadataReferenceIndex::OnRenameVariableReferences(UBlueprint* InBlueprint, UClass* InVariableClass, const FName& InOldVarName, const FName& InNewVarName)
+{
+	// The event is also broadcast for Blueprints that merely use the variable. Those that may refer to it in metadata
+	// (the owner and its children) are all handled when it is broadcast for the owner.
+	if (!InBlueprint || !InVariableClass || (InVariableClass != InBlueprint->GeneratedClass && InVariableClass != InBlueprint->SkeletonGeneratedClass))
+	{
+		return;
+	}
+
+	const IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(AssetRegistryConstants::ModuleName).Get();
+	TArray<FSoftObjectPath> Blueprints = { FSoftObjectPath(InBlueprint) };
+	if (InBlueprint->GeneratedClass)
+	{
+		TSet<FTopLevelAssetPath> DerivedClassPaths;
+		AssetRegistry.GetDerivedClassNames({ InBlueprint->GeneratedClass->GetClassPathName() }, {}, DerivedClassPaths);
+		for (const FTopLevelAssetPath& ClassPath : DerivedClassPaths)
+		{
+			Blueprints.AddUnique(GetBlueprintPathFromClassPath(ClassPath));
+		}
+
+		// Children that haven't been saved yet are only known in memory.
+		TArray<UClass*> DerivedClasses;
+		GetDerivedClasses(InBlueprint->GeneratedClass, DerivedClasses);
+		for (const UClass* Class : DerivedClasses)
+		{
+			const UBlueprint* ChildBlueprint = UBlueprint::GetBlueprintFromClass(Class);
+			if (ChildBlueprint && ChildBlueprint->GeneratedClass == Class)
+			{
+				Blueprints.AddUnique(FSoftObjectPath(ChildBlueprint));
+			}
+		}
+	}
+
+	// Loaded Blueprints may have metadata that hasn't been saved to their tags yet, so those are indexed from memory.
+	// Blueprints that were saved before the plugin was enabled have no tag, and aren't in the index until they are loaded.
+	TArray<FReference> Found;
+	TArray<FString> LoadedUntagged;
+	for (const FSoftObjectPath& Path : Blueprints)
+	{
+		const UBlueprint* Loaded = Cast<UBlueprint>(Path.ResolveObject());
+		if (!Loaded)
+		{
+			const FAssetData AssetData = AssetRegistry.GetAssetByObjectPath(Path);
+			if (AssetData.IsValid() && !FNeatMetadataAssetTags::IsTagged(AssetData))
+			{
+				Loaded = Cast<UBlueprint>(Path.TryLoad());
+				if (Loaded)
+				{
+					LoadedUntagged.Add(Path.GetAssetName());
+				}
+				else
+				{
+					UE_LOG(LogNeatMetadata, Warning, TEXT("Couldn't load %s to look for references to %s."), *Path.ToString(), *InOldVarName.ToString());
+				}
+			}
+		}
+
+		if (Loaded)
+		{
+			IndexLoadedBlueprint(*Loaded);
+		}
+		FindReferences({ FName(Path.ToString()), InOldVarName, ESymbolKind::Variable }, Found);
+	}
+
+	if (!LoadedUntagged.IsEmpty())
+	{
+		UE_LOG(LogNeatMetadata, Log, TEXT("Loaded %d Blueprints without the %s tag to look for references to %s: %s. Resave them with -run=NeatMetadata -ResaveUntagged to avoid this."),
+			LoadedUntagged.Num(), *FNeatMetadataAssetTags::TagName.ToString(), *InOldVarName.ToString(), *FString::Join(LoadedUntagged, TEXT(", ")));
+	}
+
+	if (Found.IsEmpty())
+	{
+		return;
+	}
+
+	TArray<UBlueprint*> Changed;
+	{
+		// All values are written through one batch, which records a single undo entry per Blueprint.
+		const FScopedTransaction Transaction(INVTEXT("Rename Variable References In Metadata"));
+		FNeatMetadataBatch Batch;
+		for (const FReference& Reference : Found)
+		{
+			// Unloaded children are only loaded if they actually refer to the variable.
+			UBlueprint* Blueprint = Cast<UBlueprint>(Reference.Blueprint.TryLoad());
+			if (!Blueprint)
+			{
+				UE_LOG(LogNeatMetadata, Warning, TEXT("Couldn't load %s to update references to %s."), *Reference.Blueprint.ToString(), *InOldVarName.ToString());
+				continue;
+			}
+
+			// The renamed variable may refer to other variables, and has already been given its new name.
+			FName VarName = Reference.Variable;
+			int32 VarIndex = FNeatMetadataVariableIndex::Get().FindIndex(*Blueprint, VarName);
+			if (VarIndex == INDEX_NONE && Blueprint == InBlueprint && VarName == InOldVarName)
+			{
+				VarName = InNewVarName;
+				VarIndex = FNeatMetadataVariableIndex::Get().FindIndex(*Blueprint, VarName);
+			}
+			if (VarIndex == INDEX_NONE)
+			{
+				continue;
+			}
+
+			const FBPVariableDescription& Variable = Blueprint->NewVariables[VarIndex];
+			const int32 EntryIndex = Variable.FindMetaDataEntryIndexForKey(Reference.Key);
+			if (EntryIndex == INDEX_NONE)
+			{
+				continue;
+			}
+
+			// Replace from the back, so that earlier ranges stay valid.
+			const FString& OldValue = Variable.MetaDataArray[EntryIndex].DataValue;
+			TArray<TPair<int32, int32>, TInlineAllocator<4>> Ranges;
+			ForEachSymbol(NAME_None, Reference.Key, OldValue, [&](const FSymbol& Symbol, int32 Start, int32 Len)
+			{
+				if (Symbol.Kind == ESymbolKind::Variable && Symbol.Name == InOldVarName)
+				{
+					Ranges.Emplace(Start, Len);
+				}
+			});
+
+			FString NewValue = OldValue;
+			for (int32 Index = Ranges.Num() - 1; Index >= 0; Index--)
+			{
+				NewValue.RemoveAt(Ranges[Index].Key, Ranges[Index].Value, false);
+				NewValue.InsertAt(Ranges[Index].Key, InNewVarName.ToString());
+			}
+
+			if (NewValue != OldValue)
+			{
+				Batch.SetMetadata(Blueprint, VarName, Reference.Key, NewValue);
+				Changed.AddUnique(Blueprint);
+			}
+		}
+	}
+
+	for (const UBlueprint* Blueprint : Changed)
+	{
+		IndexLoadedBlueprint(*Blueprint);
+	}
+	UE_LOG(LogNeatMetadata, Display, TEXT("Updated metadata that refers to %s in %d Blueprints."), *InNewVarName.ToString(), Changed.Num());
+}
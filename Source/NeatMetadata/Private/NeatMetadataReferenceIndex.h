@@ -0,0 +1,103 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#pragma once
+#include "CoreMinimal.h"
+
+class UBlueprint;
+class UPackage;
+struct FAssetData;
+struct FNeatMetadataVariableSummary;
+class FObjectPostSaveContext;
+
+/**
+ * Index from symbols that are referenced by name inside metadata values, to the variables whose metadata refers to them.
+ * E.g. `EditCondition = "bEnabled && Count > 0"` on a variable refers to the variables `bEnabled` and `Count`.
+ *
+ * The index is built from the asset registry tags written by FNeatMetadataAssetTags, so nothing has to be loaded, and is
+ * then kept up to date as assets are saved, added, removed and renamed. When a Blueprint variable is renamed, all metadata
+ * that refers to it is rewritten in a single transaction.
+ */
+class FNeatMetadataReferenceIndex
+{
+public:
+	static FNeatMetadataReferenceIndex& Get();
+	static void TearDown();
+
+	~FNeatMetadataReferenceIndex();
+
+	enum class ESymbolKind : uint8
+	{
+		// A variable on the Blueprint, or on one of its parents.
+		Variable,
+		// A function on the Blueprint, or a static function on the class in Scope.
+		Function,
+		// A property on the struct of the variable. The scope is unknown without loading the variable's type.
+		StructField,
+	};
+
+	struct FSymbol
+	{
+		// Object path of the Blueprint or class the name is looked up in. None if unknown.
+		FName Scope;
+		FName Name;
+		ESymbolKind Kind = ESymbolKind::Variable;
+
+		bool operator==(const FSymbol& Other) const { return Scope == Other.Scope && Name == Other.Name && Kind == Other.Kind; }
+		friend uint32 GetTypeHash(const FSymbol& InSymbol) { return HashCombine(HashCombine(GetTypeHash(InSymbol.Scope), GetTypeHash(InSymbol.Name)), uint32(InSymbol.Kind)); }
+	};
+
+	struct FReference
+	{
+		FSoftObjectPath Blueprint;
+		FName Variable;
+		// The metadata key that contains the reference.
+		FName Key;
+
+		bool operator==(const FReference& Other) const { return Blueprint == Other.Blueprint && Variable == Other.Variable && Key == Other.Key; }
+	};
+
+	/**
+	 * @brief Finds all variables whose metadata refers to a symbol.
+	 * @param InSymbol The symbol to look for.
+	 * @param OutReferences Receives the references.
+	 */
+	void FindReferences(const FSymbol& InSymbol, TArray<FReference>& OutReferences) const;
+
+	using FForEachSymbolSignature = void(const FSymbol& /*Symbol*/, int32 /*Start*/, int32 /*Len*/);
+	/**
+	 * @brief Parses a metadata value, and finds the symbols it refers to.
+	 * @param InScope Object path of the Blueprint that owns the variable.
+	 * @param InKey The metadata key. Keys that don't refer to symbols are ignored.
+	 * @param InValue The metadata value.
+	 * @param Functor Functor that executes for each symbol, with the range of the value that names it.
+	 */
+	static void ForEachSymbol(FName InScope, FName InKey, FStringView InValue, TFunctionRef<FForEachSymbolSignature> Functor);
+
+private:
+	FNeatMetadataReferenceIndex();
+
+	void Build();
+	void IndexBlueprint(const FSoftObjectPath& InBlueprint, TConstArrayView<FNeatMetadataVariableSummary> InVariables);
+	void IndexLoadedBlueprint(const UBlueprint& InBlueprint);
+	void RemoveBlueprint(const FSoftObjectPath& InBlueprint);
+
+	void OnAssetAddedOrUpdated(const FAssetData& InAssetData);
+	void OnAssetRemoved(const FAssetData& InAssetData);
+	void OnAssetRenamed(const FAssetData& InAssetData, const FString& InOldObjectPath);
+	void OnPackageSaved(const FString& InFilename, UPackage* InPackage, FObjectPostSaveContext InContext);
+	void OnRenameVariableReferences(UBlueprint* InBlueprint, UClass* InVariableClass, const FName& InOldVarName, const FName& InNewVarName);
+
+	TMap<FSymbol, TArray<FReference>> References;
+	// The symbols each Blueprint refers to, so that its references can be removed without searching.
+	TMap<FSoftObjectPath, TArray<FSymbol>> SymbolsByBlueprint;
+	bool bIsBuilt = false;
+
+	FDelegateHandle FilesLoadedHandle;
+	FDelegateHandle AssetAddedHandle;
+	FDelegateHandle AssetUpdatedHandle;
+	FDelegateHandle AssetRemovedHandle;
+	FDelegateHandle AssetRenamedHandle;
+	FDelegateHandle PackageSavedHandle;
+	FDelegateHandle RenameVariableReferencesHandle;
+
+	static TUniquePtr<FNeatMetadataReferenceIndex> Instance;
+};
@@ -0,0 +1,128 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#include "NeatMetadataRelevanceCache.h"
+#include "NeatMetadataCollection.h"
+
+#include "Engine/DataAsset.h"
+
+namespace
+{
+	const UObject* GetTypeObject(const FProperty& InProperty)
+	{
+		if (const FStructProperty* AsStruct = CastField<FStructProperty>(&InProperty))
+		{
+			return AsStruct->Struct;
+		}
+
+		if (const FClassProperty* AsClass = CastField<FClassProperty>(&InProperty))
+		{
+			return AsClass->MetaClass;
+		}
+
+		if (const FSoftClassProperty* AsSoftClass = CastField<FSoftClassProperty>(&InProperty))
+		{
+			return AsSoftClass->MetaClass;
+		}
+
+		if (const FObjectPropertyBase* AsObject = CastField<FObjectPropertyBase>(&InProperty))
+		{
+			return AsObject->PropertyClass;
+		}
+
+		if (const FInterfaceProperty* AsInterface = CastField<FInterfaceProperty>(&InProperty))
+		{
+			return AsInterface->InterfaceClass;
+		}
+
+		if (const FByteProperty* AsByte = CastField<FByteProperty>(&InProperty))
+		{
+			return AsByte->Enum;
+		}
+
+		if (const FEnumProperty* AsEnum = CastField<FEnumProperty>(&InProperty))
+		{
+			return AsEnum->GetEnum();
+		}
+
+		return nullptr;
+	}
+}
+
+FNeatPropertyTypeSignature::FNeatPropertyTypeSignature(const FProperty& InProperty)
+{
+	if (const FArrayProperty* AsArray = CastField<FArrayProperty>(&InProperty))
+	{
+		ContainerKind = ENeatPropertyContainerKind::Array;
+		SetElement(0, AsArray->Inner);
+	}
+	else if (const FSetProperty* AsSet = CastField<FSetProperty>(&InProperty))
+	{
+		ContainerKind = ENeatPropertyContainerKind::Set;
+		SetElement(0, AsSet->ElementProp);
+	}
+	else if (const FMapProperty* AsMap = CastField<FMapProperty>(&InProperty))
+	{
+		ContainerKind = ENeatPropertyContainerKind::Map;
+		SetElement(0, AsMap->GetKeyProperty());
+		SetElement(1, AsMap->GetValueProperty());
+	}
+	else
+	{
+		SetElement(0, &InProperty);
+	}
+
+	const UClass* OwnerClass = InProperty.GetOwnerClass();
+	bOwnerIsPrimaryDataAsset = OwnerClass && OwnerClass->IsChildOf<UPrimaryDataAsset>();
+
+	Hash = GetTypeHash(ContainerKind);
+	for (int32 Idx = 0; Idx < UE_ARRAY_COUNT(FieldClasses); Idx++)
+	{
+		Hash = HashCombine(Hash, PointerHash(FieldClasses[Idx]));
+		Hash = HashCombine(Hash, PointerHash(TypeObjects[Idx]));
+	}
+	Hash = HashCombine(Hash, GetTypeHash(bOwnerIsPrimaryDataAsset));
+}
+
+bool FNeatPropertyTypeSignature::operator==(const FNeatPropertyTypeSignature& Other) const
+{
+	return Hash == Other.Hash
+		&& ContainerKind == Other.ContainerKind
+		&& bOwnerIsPrimaryDataAsset == Other.bOwnerIsPrimaryDataAsset
+		&& FieldClasses[0] == Other.FieldClasses[0]
+		&& FieldClasses[1] == Other.FieldClasses[1]
+		&& TypeObjects[0] == Other.TypeObjects[0]
+		&& TypeObjects[1] == Other.TypeObjects[1];
+}
+
+void FNeatPropertyTypeSignature::SetElement(int32 Index, const FProperty* InProperty)
+{
+	if (InProperty)
+	{
+		FieldClasses[Index] = InProperty->GetClass();
+		TypeObjects[Index] = GetTypeObject(*InProperty);
+	}
+}
+
+const TArray<int32>& FNeatMetadataRelevanceCache::FindOrAdd(const FProperty& InProperty, TConstArrayView<TObjectPtr<UNeatMetadataCollection>> InCollections)
+{
+	const FNeatPropertyTypeSignature Signature(InProperty);
+	if (const TArray<int32>* Found = Entries.Find(Signature))
+	{
+		return *Found;
+	}
+
+	TArray<int32> RelevantIndices;
+	for (int32 Idx = 0; Idx < InCollections.Num(); Idx++)
+	{
+		if (InCollections[Idx] && InCollections[Idx]->IsRelevantForProperty(InProperty))
+		{
+			RelevantIndices.Add(Idx);
+		}
+	}
+
+	return Entries.Add(Signature, MoveTemp(RelevantIndices));
+}
+
+void FNeatMetadataRelevanceCache::Reset()
+{
+	Entries.Reset();
+}
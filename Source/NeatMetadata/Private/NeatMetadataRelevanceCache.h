@@ -0,0 +1,60 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#pragma once
+#include "CoreMinimal.h"
+
+class UNeatMetadataCollection;
+
+enum class ENeatPropertyContainerKind : uint8
+{
+	None,
+	Array,
+	Set,
+	Map,
+};
+
+/**
+ * Canonical description of the type of a blueprint variable. Two properties with the same signature are considered to be
+ * equal by UNeatMetadataCollection::IsRelevantForProperty, which allows the result of that function to be cached.
+ */
+struct FNeatPropertyTypeSignature
+{
+	explicit FNeatPropertyTypeSignature(const FProperty& InProperty);
+
+	bool operator==(const FNeatPropertyTypeSignature& Other) const;
+	friend uint32 GetTypeHash(const FNeatPropertyTypeSignature& Signature) { return Signature.Hash; }
+
+private:
+	void SetElement(int32 Index, const FProperty* InProperty);
+
+	// Element 0 is the property itself, or the inner/key property of a container. Element 1 is the value property of a map.
+	const FFieldClass* FieldClasses[2] = {};
+	// The struct, class or enum that further describes the type of each element.
+	const UObject* TypeObjects[2] = {};
+	ENeatPropertyContainerKind ContainerKind = ENeatPropertyContainerKind::None;
+	bool bOwnerIsPrimaryDataAsset = false;
+	uint32 Hash = 0;
+};
+
+/**
+ * Maps property type signatures to the collections that are relevant for that type, so that clicking through variables
+ * doesn't have to ask every collection whether it's relevant each time.
+ *
+ * The cached lists store indices into the collection array they were built from, so the cache must be reset whenever
+ * that array changes.
+ */
+class FNeatMetadataRelevanceCache
+{
+public:
+	/**
+	 * @brief Finds the collections relevant for the input property, evaluating and caching them if this type hasn't been seen before.
+	 * @param InProperty The property representing the blueprint variable.
+	 * @param InCollections All active collections.
+	 * @return Indices into InCollections, in order.
+	 */
+	const TArray<int32>& FindOrAdd(const FProperty& InProperty, TConstArrayView<TObjectPtr<UNeatMetadataCollection>> InCollections);
+
+	void Reset();
+
+private:
+	TMap<FNeatPropertyTypeSignature, TArray<int32>> Entries;
+};
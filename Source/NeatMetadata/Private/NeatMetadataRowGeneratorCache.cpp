@@ -0,0 +1,99 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#include "NeatMetadataRowGeneratorCache.h"
+#include "NeatMetadataCollection.h"
+
+#include "IPropertyRowGenerator.h"
+#include "IDetailTreeNode.h"
+#include "PropertyEditorModule.h"
+#include "PropertyHandle.h"
+
+TUniquePtr<FNeatMetadataRowGeneratorCache> FNeatMetadataRowGeneratorCache::Instance;
+
+FNeatMetadataRowGeneratorCache& FNeatMetadataRowGeneratorCache::Get()
+{
+	if (!Instance)
+	{
+		Instance = TUniquePtr<FNeatMetadataRowGeneratorCache>(new FNeatMetadataRowGeneratorCache());
+	}
+	return *Instance;
+}
+
+void FNeatMetadataRowGeneratorCache::TearDown()
+{
+	Instance.Reset();
+}
+
+TSharedPtr<IPropertyHandle> FNeatMetadataRowGeneratorCache::FindHandle(UNeatMetadataCollection& InCollection, FName InPropertyName)
+{
+	FEntry& Entry = FindOrAddEntry(InCollection);
+	if (Entry.bHandlesDirty)
+	{
+		Entry.Handles.Reset();
+		GatherHandles(Entry.Generator->GetRootTreeNodes(), Entry.Handles);
+		Entry.bHandlesDirty = false;
+	}
+
+	const TSharedPtr<IPropertyHandle>* Found = Entry.Handles.Find(InPropertyName);
+	return Found && (*Found)->IsValidHandle() ? *Found : nullptr;
+}
+
+void FNeatMetadataRowGeneratorCache::RefreshValues(UNeatMetadataCollection& InCollection)
+{
+	if (FEntry* Entry = Entries.Find(FObjectKey(&InCollection)))
+	{
+		Entry->Generator->InvalidateCachedState();
+	}
+}
+
+void FNeatMetadataRowGeneratorCache::Reset()
+{
+	Entries.Reset();
+}
+
+FNeatMetadataRowGeneratorCache::FEntry& FNeatMetadataRowGeneratorCache::FindOrAddEntry(UNeatMetadataCollection& InCollection)
+{
+	const FObjectKey Key(&InCollection);
+	if (FEntry* Found = Entries.Find(Key))
+	{
+		return *Found;
+	}
+
+	FPropertyEditorModule& PropertyEditorModule = FModuleManager::LoadModuleChecked<FPropertyEditorModule>("PropertyEditor");
+
+	FEntry& Entry = Entries.Add(Key);
+	Entry.Generator = PropertyEditorModule.CreatePropertyRowGenerator(FPropertyRowGeneratorArgs());
+	Entry.Generator->SetObjects({ &InCollection });
+
+	// The generator rebuilds its node tree when the structure of the object changes, e.g. when an array is resized,
+	// which invalidates all handles that have been handed out.
+	Entry.Generator->OnRowsRefreshed().AddLambda([this, Key]()
+	{
+		if (FEntry* RefreshedEntry = Entries.Find(Key))
+		{
+			RefreshedEntry->bHandlesDirty = true;
+		}
+	});
+	
+	return Entry;
+}
+
+void FNeatMetadataRowGeneratorCache::GatherHandles(const TArray<TSharedRef<IDetailTreeNode>>& InNodes, TMap<FName, TSharedPtr<IPropertyHandle>>& OutHandles)
+{
+	for (const TSharedRef<IDetailTreeNode>& Node : InNodes)
+	{
+		if (Node->GetNodeType() == EDetailNodeType::Item)
+		{
+			const TSharedPtr<IPropertyHandle> Handle = Node->CreatePropertyHandle();
+			if (Handle && Handle->GetProperty())
+			{
+				OutHandles.Add(Handle->GetProperty()->GetFName(), Handle);
+			}
+			continue;
+		}
+
+		// Member properties are nested in category (and possibly object) nodes.
+		TArray<TSharedRef<IDetailTreeNode>> Children;
+		Node->GetChildren(Children);
+		GatherHandles(Children, OutHandles);
+	}
+}
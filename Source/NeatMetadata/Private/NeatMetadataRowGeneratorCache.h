@@ -0,0 +1,56 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#pragma once
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class IPropertyHandle;
+class IPropertyRowGenerator;
+class IDetailTreeNode;
+class UNeatMetadataCollection;
+
+/**
+ * Keeps one property row generator alive for each collection instance, so that the property node tree of a collection is
+ * only built once. The metadata customization reuses the handles from these generators for every selection, instead of
+ * adding every relevant collection to the details panel as a new external object.
+ */
+class FNeatMetadataRowGeneratorCache
+{
+public:
+	static FNeatMetadataRowGeneratorCache& Get();
+	static void TearDown();
+
+	/**
+	 * @brief Finds the handle for a member property of a collection, creating the row generator for the collection if needed.
+	 * @param InCollection The collection that owns the property.
+	 * @param InPropertyName The name of the property.
+	 * @return The handle, or nullptr if the generator has no row for the property.
+	 */
+	TSharedPtr<IPropertyHandle> FindHandle(UNeatMetadataCollection& InCollection, FName InPropertyName);
+
+	/**
+	 * @brief Makes the generator for the collection pick up values that were changed outside of the property editor,
+	 * for example after UNeatMetadataCollection::InitializeFromMetadata.
+	 * @param InCollection The collection that changed.
+	 */
+	void RefreshValues(UNeatMetadataCollection& InCollection);
+
+	// Discards all generators. Must be called when the collection instances change.
+	void Reset();
+
+private:
+	FNeatMetadataRowGeneratorCache() = default;
+
+	struct FEntry
+	{
+		TSharedPtr<IPropertyRowGenerator> Generator;
+		TMap<FName, TSharedPtr<IPropertyHandle>> Handles;
+		bool bHandlesDirty = true;
+	};
+
+	FEntry& FindOrAddEntry(UNeatMetadataCollection& InCollection);
+	static void GatherHandles(const TArray<TSharedRef<IDetailTreeNode>>& InNodes, TMap<FName, TSharedPtr<IPropertyHandle>>& OutHandles);
+
+	TMap<FObjectKey, FEntry> Entries;
+
+	static TUniquePtr<FNeatMetadataRowGeneratorCache> Instance;
+};
@@ -3,8 +3,12 @@
 
 #include "NeatMetadataSettings.h"
 #include "NeatMetadataCollection.h"
+#include "NeatMetadataCollectionRegistry.h"
+#include "NeatMetadataRelevanceCache.h"
+#include "NeatMetadataCollectionLayout.h"
+#include "NeatMetadataRowGeneratorCache.h"
 
-UNeatMetadataSettings::UNeatMetadataSettings()
+UNeatMetadataSettings::UNeatMetadataSettings() : RelevanceCache(MakeShared<FNeatMetadataRelevanceCache>())
 {
 	CategoryName = "Plugins";
 
@@ -28,31 +32,33 @@ void UNeatMetadataSettings::ForEachCollection(TFunctionRef<FForEachCollectionSig
 	}
 }
 
+void UNeatMetadataSettings::ForEachRelevantCollection(const FProperty& InProperty, TFunctionRef<FForEachCollectionSignature> Functor) const
+{
+	for (const int32 Index : RelevanceCache->FindOrAdd(InProperty, MetadataCollectionInstances))
+	{
+		check(MetadataCollectionInstances.IsValidIndex(Index) && MetadataCollectionInstances[Index]);
+		Functor(*MetadataCollectionInstances[Index]);
+	}
+}
+
 void UNeatMetadataSettings::RebuildMetadataCollections()
 {
-	MetadataCollectionInstances.Empty();
+	FNeatMetadataCollectionRegistry& Registry = FNeatMetadataCollectionRegistry::Get();
 	
+	TSet<const UClass*> DesiredClasses;
 	if (AllowedCollections.IsEmpty())
 	{
-		// TODO: Support blueprint classes too? Right now they are not guaranteed to be loaded, so we have to load them through the asset registry.
-		for (UClass* Class : TObjectRange<UClass>())
+		Registry.ForEachClass([&](UClass& Class)
 		{
-			if (!Class->IsChildOf(UNeatMetadataCollection::StaticClass()) || Class->HasAnyClassFlags(CLASS_Abstract | CLASS_Deprecated))
-			{
-				continue;
-			}
-
-			if (DisallowedCollections.Contains(Class))
+			if (!DisallowedCollections.Contains(&Class))
 			{
-				continue;
+				DesiredClasses.Add(&Class);
 			}
-
-			MetadataCollectionInstances.Add(NewObject<UNeatMetadataCollection>(this, Class));
-		}
+		});
 	}
 	else
 	{
-		MetadataCollectionInstances.Reserve(AllowedCollections.Num());
+		DesiredClasses.Reserve(AllowedCollections.Num());
 
 		for (TSoftClassPtr<UNeatMetadataCollection> SoftClass : AllowedCollections)
 		{
@@ -61,14 +67,38 @@ void UNeatMetadataSettings::RebuildMetadataCollections()
 				continue;
 			}
 
-			const UClass* LoadedClass = SoftClass.LoadSynchronous();
-			if (ensure(LoadedClass))
+			// Classes that aren't loaded yet are streamed in, and join the active set once the registry is notified about them.
+			if (const UClass* LoadedClass = SoftClass.Get())
 			{
-				MetadataCollectionInstances.Add(NewObject<UNeatMetadataCollection>(this, LoadedClass));
+				DesiredClasses.Add(LoadedClass);
+			}
+			else
+			{
+				Registry.RequestAsyncLoad(SoftClass.ToSoftObjectPath());
 			}
 		}
 	}
 
+	// Collection classes may have been reinstanced, which invalidates their property layouts.
+	FNeatMetadataCollectionLayout::Reset();
+
+	// Only diff against what we already have, so that collections that are still relevant keep their instances.
+	const int32 NumRemoved = MetadataCollectionInstances.RemoveAll([&](const TObjectPtr<UNeatMetadataCollection>& Collection)
+	{
+		return !Collection || DesiredClasses.Remove(Collection->GetClass()) == 0;
+	});
+
+	if (NumRemoved == 0 && DesiredClasses.IsEmpty())
+	{
+		return;
+	}
+
+	MetadataCollectionInstances.Reserve(MetadataCollectionInstances.Num() + DesiredClasses.Num());
+	for (const UClass* Class : DesiredClasses)
+	{
+		MetadataCollectionInstances.Add(NewObject<UNeatMetadataCollection>(this, Class));
+	}
+
 	// Sort groups. Not sure if this is the best sort order, or if we should sort them differently.
 	// General should maybe always be on top, for example?
 	auto GetGroupName = [](const UNeatMetadataCollection& InCollection)
@@ -81,6 +111,15 @@ void UNeatMetadataSettings::RebuildMetadataCollections()
 	{
 		return GetGroupName(InA) < GetGroupName(InB);
 	});
+
+	// The cache stores indices into MetadataCollectionInstances.
+	RelevanceCache->Reset();
+	FNeatMetadataRowGeneratorCache::Get().Reset();
+}
+
+void UNeatMetadataSettings::ResetRelevanceCache()
+{
+	RelevanceCache->Reset();
 }
 
 void UNeatMetadataSettings::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
@@ -98,6 +137,15 @@ void UNeatMetadataSettings::PostInitProperties()
 {
 	Super::PostInitProperties();
 
+	if (HasAnyFlags(RF_ClassDefaultObject))
+	{
+		FNeatMetadataCollectionRegistry::Get().OnChanged().AddUObject(this, &ThisClass::RebuildMetadataCollections);
+
+		// Signatures reference types by pointer. Blueprint structs and classes may be garbage collected when they are recompiled,
+		// so don't risk a new type ending up at the address of an old one.
+		FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &ThisClass::ResetRelevanceCache);
+	}
+
 	RebuildMetadataCollections();
 }
 
@@ -105,3 +153,26 @@ UNeatMetadataUserSettings::UNeatMetadataUserSettings()
 {
 	CategoryName = "Plugins";
 }
+
+bool UNeatMetadataUserSettings::IsGroupExpanded(FName InGroupName) const
+{
+	return ExpandedGroups.Contains(InGroupName);
+}
+
+void UNeatMetadataUserSettings::SetGroupExpanded(FName InGroupName, bool bInExpanded)
+{
+	if (IsGroupExpanded(InGroupName) == bInExpanded)
+	{
+		return;
+	}
+
+	if (bInExpanded)
+	{
+		ExpandedGroups.Add(InGroupName);
+	}
+	else
+	{
+		ExpandedGroups.Remove(InGroupName);
+	}
+	SaveConfig();
+}
@@ -0,0 +1,28 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#include "NeatMetadataVariableHandle.h"
+#include "NeatMetadataVariableIndex.h"
+#include "Engine/Blueprint.h"
+
+FNeatMetadataVariableHandle::FNeatMetadataVariableHandle(UBlueprint* InBlueprint, FName InVarName) :
+	Blueprint(InBlueprint),
+	VarName(InVarName)
+{
+}
+
+FBPVariableDescription* FNeatMetadataVariableHandle::Get() const
+{
+	UBlueprint* BlueprintPtr = Blueprint.Get();
+	if (!BlueprintPtr || VarName.IsNone())
+	{
+		return nullptr;
+	}
+
+	FNeatMetadataVariableIndex& Index = FNeatMetadataVariableIndex::Get();
+	const bool bIsSameGeneration = CachedGeneration != 0 && CachedGeneration == Index.GetGeneration(*BlueprintPtr);
+	if (!bIsSameGeneration || !BlueprintPtr->NewVariables.IsValidIndex(CachedIndex) || BlueprintPtr->NewVariables[CachedIndex].VarName != VarName)
+	{
+		CachedIndex = Index.FindIndex(*BlueprintPtr, VarName, CachedGeneration);
+	}
+
+	return CachedIndex != INDEX_NONE ? &BlueprintPtr->NewVariables[CachedIndex] : nullptr;
+}
@@ -0,0 +1,123 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#include "NeatMetadataVariableIndex.h"
+#include "Engine/Blueprint.h"
+
+TUniquePtr<FNeatMetadataVariableIndex> FNeatMetadataVariableIndex::Instance;
+
+FNeatMetadataVariableIndex& FNeatMetadataVariableIndex::Get()
+{
+	if (!Instance)
+	{
+		Instance = TUniquePtr<FNeatMetadataVariableIndex>(new FNeatMetadataVariableIndex());
+	}
+	return *Instance;
+}
+
+void FNeatMetadataVariableIndex::TearDown()
+{
+	Instance.Reset();
+}
+
+FNeatMetadataVariableIndex::FNeatMetadataVariableIndex()
+{
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddRaw(this, &FNeatMetadataVariableIndex::OnPostGarbageCollect);
+}
+
+FNeatMetadataVariableIndex::~FNeatMetadataVariableIndex()
+{
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+
+	for (const TPair<FObjectKey, FEntry>& Pair : Entries)
+	{
+		if (UBlueprint* Blueprint = Pair.Value.Blueprint.Get())
+		{
+			Blueprint->OnChanged().Remove(Pair.Value.ChangedHandle);
+			Blueprint->OnCompiled().Remove(Pair.Value.CompiledHandle);
+		}
+	}
+}
+
+int32 FNeatMetadataVariableIndex::FindIndex(UBlueprint& InBlueprint, FName InVarName, uint32& OutGeneration)
+{
+	FEntry& Entry = FindOrAddEntry(InBlueprint);
+	if (Entry.bDirty)
+	{
+		Rebuild(Entry, InBlueprint);
+	}
+
+	// Not every change to NewVariables is broadcast, e.g. a rename, so verify the result and rebuild if the table turned
+	// out to be stale. A miss can't be verified without searching, since the variable may have been renamed to this name.
+	const int32* FoundIndex = Entry.NameToIndex.Find(InVarName);
+	const bool bIsUpToDate = FoundIndex
+		? InBlueprint.NewVariables.IsValidIndex(*FoundIndex) && InBlueprint.NewVariables[*FoundIndex].VarName == InVarName
+		: !InBlueprint.NewVariables.ContainsByPredicate([InVarName](const FBPVariableDescription& Variable) { return Variable.VarName == InVarName; });
+
+	if (!bIsUpToDate)
+	{
+		Rebuild(Entry, InBlueprint);
+		FoundIndex = Entry.NameToIndex.Find(InVarName);
+	}
+
+	OutGeneration = Entry.Generation;
+	return FoundIndex ? *FoundIndex : INDEX_NONE;
+}
+
+int32 FNeatMetadataVariableIndex::FindIndex(UBlueprint& InBlueprint, FName InVarName)
+{
+	uint32 Generation;
+	return FindIndex(InBlueprint, InVarName, Generation);
+}
+
+uint32 FNeatMetadataVariableIndex::GetGeneration(const UBlueprint& InBlueprint) const
+{
+	const FEntry* Entry = Entries.Find(FObjectKey(&InBlueprint));
+	return Entry && !Entry->bDirty ? Entry->Generation : 0;
+}
+
+FNeatMetadataVariableIndex::FEntry& FNeatMetadataVariableIndex::FindOrAddEntry(UBlueprint& InBlueprint)
+{
+	const FObjectKey Key(&InBlueprint);
+	if (FEntry* Found = Entries.Find(Key))
+	{
+		return *Found;
+	}
+
+	FEntry& Entry = Entries.Add(Key);
+	Entry.Blueprint = &InBlueprint;
+	Entry.ChangedHandle = InBlueprint.OnChanged().AddRaw(this, &FNeatMetadataVariableIndex::Invalidate);
+	Entry.CompiledHandle = InBlueprint.OnCompiled().AddRaw(this, &FNeatMetadataVariableIndex::Invalidate);
+	return Entry;
+}
+
+void FNeatMetadataVariableIndex::Rebuild(FEntry& InEntry, const UBlueprint& InBlueprint)
+{
+	InEntry.NameToIndex.Reset();
+	InEntry.NameToIndex.Reserve(InBlueprint.NewVariables.Num());
+	for (int32 Idx = 0; Idx < InBlueprint.NewVariables.Num(); Idx++)
+	{
+		// Keep the first occurrence, like FBlueprintEditorUtils::FindNewVariableIndex.
+		InEntry.NameToIndex.FindOrAdd(InBlueprint.NewVariables[Idx].VarName, Idx);
+	}
+
+	InEntry.Generation = NextGeneration++;
+	InEntry.bDirty = false;
+}
+
+void FNeatMetadataVariableIndex::Invalidate(UBlueprint* InBlueprint)
+{
+	if (FEntry* Entry = InBlueprint ? Entries.Find(FObjectKey(InBlueprint)) : nullptr)
+	{
+		Entry->bDirty = true;
+	}
+}
+
+void FNeatMetadataVariableIndex::OnPostGarbageCollect()
+{
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		if (!It->Value.Blueprint.IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
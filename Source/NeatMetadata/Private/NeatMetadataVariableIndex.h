@@ -0,0 +1,59 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#pragma once
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class UBlueprint;
+
+/**
+ * Per-Blueprint name to index tables for UBlueprint::NewVariables, so that variable descriptions can be found without a
+ * linear search. Each Blueprint has a generation that is bumped whenever the Blueprint reports that it changed, or when a
+ * lookup finds that the table is out of date.
+ */
+class FNeatMetadataVariableIndex
+{
+public:
+	static FNeatMetadataVariableIndex& Get();
+	static void TearDown();
+
+	~FNeatMetadataVariableIndex();
+
+	/**
+	 * @brief Finds the index of a variable in NewVariables.
+	 * @param InBlueprint The blueprint to search.
+	 * @param InVarName The name of the variable.
+	 * @param OutGeneration The generation the returned index is valid for.
+	 * @return The index, or INDEX_NONE if there is no such variable.
+	 */
+	int32 FindIndex(UBlueprint& InBlueprint, FName InVarName, uint32& OutGeneration);
+	int32 FindIndex(UBlueprint& InBlueprint, FName InVarName);
+
+	/**
+	 * @brief The current generation of the input blueprint. Indices from other generations must be validated before use.
+	 */
+	uint32 GetGeneration(const UBlueprint& InBlueprint) const;
+
+private:
+	FNeatMetadataVariableIndex();
+
+	struct FEntry
+	{
+		TMap<FName, int32> NameToIndex;
+		uint32 Generation = 0;
+		bool bDirty = true;
+		TWeakObjectPtr<UBlueprint> Blueprint;
+		FDelegateHandle ChangedHandle;
+		FDelegateHandle CompiledHandle;
+	};
+
+	FEntry& FindOrAddEntry(UBlueprint& InBlueprint);
+	void Rebuild(FEntry& InEntry, const UBlueprint& InBlueprint);
+	void Invalidate(UBlueprint* InBlueprint);
+	void OnPostGarbageCollect();
+
+	TMap<FObjectKey, FEntry> Entries;
+	uint32 NextGeneration = 1;
+	FDelegateHandle PostGarbageCollectHandle;
+
+	static TUniquePtr<FNeatMetadataVariableIndex> Instance;
+};
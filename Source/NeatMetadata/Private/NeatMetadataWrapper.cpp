@@ -1,11 +1,12 @@
 ﻿// Copyright Viktor Pramberg. All Rights Reserved.
 #include "NeatMetadataWrapper.h"
-#include "Kismet2/BlueprintEditorUtils.h"
+#include "NeatMetadataBatch.h"
+#include "Engine/Blueprint.h"
 
 FNeatMetadataWrapper::FNeatMetadataWrapper(TWeakFieldPtr<FProperty> InProperty, TWeakObjectPtr<UBlueprint> InBlueprint) :
 	Property(InProperty),
 	Blueprint(InBlueprint),
-	VariableDesc(Blueprint->NewVariables.FindByPredicate([this](const FBPVariableDescription& InDesc) { return InDesc.VarName == Property->GetFName(); }))
+	VariableDesc(Blueprint.Get(), Property.IsValid() ? Property->GetFName() : NAME_None)
 {
 }
 
@@ -13,8 +14,8 @@ void FNeatMetadataWrapper::SetMetadata(FName Key, const FString& Value) const
 {
 	if (IsValid())
 	{
-		Blueprint->Modify();
-		FBlueprintEditorUtils::SetBlueprintVariableMetaData(Blueprint.Get(), Property->GetFName(), nullptr, Key, Value);
+		FNeatMetadataBatch Batch;
+		Batch.SetMetadata(Blueprint.Get(), Property->GetFName(), Key, Value);
 	}
 }
 
@@ -22,24 +23,58 @@ void FNeatMetadataWrapper::RemoveMetadata(FName Key) const
 {
 	if (IsValid())
 	{
-		Blueprint->Modify();
-		FBlueprintEditorUtils::RemoveBlueprintVariableMetaData(Blueprint.Get(), Property->GetFName(), nullptr, Key);
+		FNeatMetadataBatch Batch;
+		Batch.RemoveMetadata(Blueprint.Get(), Property->GetFName(), Key);
 	}
 }
 
 FString FNeatMetadataWrapper::GetMetadata(FName Key) const
 {
-	return IsValid() && VariableDesc->HasMetaData(Key) ? VariableDesc->GetMetaData(Key) : FString();
+	if (!IsValid())
+	{
+		return FString();
+	}
+
+	if (const TOptional<FString>* Pending = FNeatMetadataBatch::FindPending(Blueprint.Get(), Property->GetFName(), Key))
+	{
+		return Pending->Get(FString());
+	}
+	
+	const FBPVariableDescription* Desc = VariableDesc.Get();
+	return Desc->HasMetaData(Key) ? Desc->GetMetaData(Key) : FString();
 }
 
 bool FNeatMetadataWrapper::HasMetadata(FName Key) const
 {
-	return IsValid() ? VariableDesc->HasMetaData(Key) : false;
+	if (!IsValid())
+	{
+		return false;
+	}
+
+	if (const TOptional<FString>* Pending = FNeatMetadataBatch::FindPending(Blueprint.Get(), Property->GetFName(), Key))
+	{
+		return Pending->IsSet();
+	}
+	
+	return VariableDesc.Get()->HasMetaData(Key);
+}
+
+void FNeatMetadataWrapper::ForEachMetadata(TFunctionRef<FForEachMetadataSignature> Functor) const
+{
+	if (!IsValid())
+	{
+		return;
+	}
+
+	for (const FBPVariableMetaDataEntry& Entry : VariableDesc.Get()->MetaDataArray)
+	{
+		Functor(Entry.DataKey, Entry.DataValue);
+	}
 }
 
 bool FNeatMetadataWrapper::IsValid() const
 {
-	return Blueprint.IsValid() && Property.IsValid() && VariableDesc;
+	return Blueprint.IsValid() && Property.IsValid() && VariableDesc.IsValid();
 }
 
 const FProperty* FNeatMetadataWrapper::GetProperty() const
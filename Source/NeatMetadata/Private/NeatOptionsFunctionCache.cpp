@@ -0,0 +1,318 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#include "NeatOptionsFunctionCache.h"
+
+#include "Editor.h"
+#include "Engine/Blueprint.h"
+#include "NeatMetadataSettings.h"
+
+#if WITH_LIVE_CODING
+#include "ILiveCodingModule.h"
+#endif
+
+TUniquePtr<FNeatOptionsFunctionCache> FNeatOptionsFunctionCache::Instance;
+
+FNeatOptionsFunctionCache& FNeatOptionsFunctionCache::Get()
+{
+	if (!Instance)
+	{
+		Instance = TUniquePtr<FNeatOptionsFunctionCache>(new FNeatOptionsFunctionCache());
+	}
+	return *Instance;
+}
+
+void FNeatOptionsFunctionCache::TearDown()
+{
+	Instance.Reset();
+}
+
+FNeatOptionsFunctionCache::FNeatOptionsFunctionCache()
+{
+	ReloadCompleteHandle = FCoreUObjectDelegates::ReloadCompleteDelegate.AddRaw(this, &FNeatOptionsFunctionCache::OnReloadComplete);
+	ModulesChangedHandle = FModuleManager::Get().OnModulesChanged().AddRaw(this, &FNeatOptionsFunctionCache::OnModulesChanged);
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddRaw(this, &FNeatOptionsFunctionCache::OnPostGarbageCollect);
+
+	if (GEditor)
+	{
+		BlueprintCompiledHandle = GEditor->OnBlueprintCompiled().AddRaw(this, &FNeatOptionsFunctionCache::OnBlueprintCompiled);
+	}
+
+#if WITH_LIVE_CODING
+	if (ILiveCodingModule* LiveCoding = FModuleManager::GetModulePtr<ILiveCodingModule>(LIVE_CODING_MODULE_NAME))
+	{
+		LiveCodingPatchCompleteHandle = LiveCoding->GetOnPatchCompleteDelegate().AddRaw(this, &FNeatOptionsFunctionCache::Reset);
+	}
+#endif
+}
+
+FNeatOptionsFunctionCache::~FNeatOptionsFunctionCache()
+{
+	UnbindAll();
+	
+	if (FModuleManager* ModuleManager = FModuleManager::GetModuleManagerIfExists())
+	{
+		ModuleManager->OnModulesChanged().Remove(ModulesChangedHandle);
+	}
+	FCoreUObjectDelegates::ReloadCompleteDelegate.Remove(ReloadCompleteHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+
+	if (PreviewTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(PreviewTickerHandle);
+	}
+
+	if (GEditor)
+	{
+		GEditor->OnBlueprintCompiled().Remove(BlueprintCompiledHandle);
+	}
+
+#if WITH_LIVE_CODING
+	if (ILiveCodingModule* LiveCoding = FModuleManager::GetModulePtr<ILiveCodingModule>(LIVE_CODING_MODULE_NAME))
+	{
+		LiveCoding->GetOnPatchCompleteDelegate().Remove(LiveCodingPatchCompleteHandle);
+	}
+#endif
+}
+
+TOptional<FString> FNeatOptionsFunctionCache::FindOrValidate(const UClass* InOwnerClass, const FString& InFunctionName, TFunctionRef<FValidateSignature> Validate)
+{
+	const FKey Key = MakeKey(InOwnerClass, InFunctionName);
+	if (const TOptional<FString>* Found = Results.Find(Key))
+	{
+		return *Found;
+	}
+
+	if (Key.OwnerClass != FObjectKey() && InOwnerClass)
+	{
+		if (UBlueprint* OwnerBlueprint = Cast<UBlueprint>(InOwnerClass->ClassGeneratedBy))
+		{
+			BindBlueprint(*OwnerBlueprint);
+		}
+	}
+
+	return Results.Add(Key, Validate());
+}
+
+const FNeatOptionsFunctionCache::FPreview& FNeatOptionsFunctionCache::FindOrRequestPreview(const UClass* InOwnerClass, const FString& InFunctionName)
+{
+	const FKey Key = MakeKey(InOwnerClass, InFunctionName);
+	if (const FPreview* Found = Previews.Find(Key))
+	{
+		return *Found;
+	}
+
+	// Running script while the details panel is being painted isn't safe, so evaluate it on a later tick.
+	PendingPreviews.Add(Key);
+	if (!PreviewTickerHandle.IsValid())
+	{
+		PreviewTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FNeatOptionsFunctionCache::TickPendingPreviews));
+	}
+	return Previews.Add(Key);
+}
+
+void FNeatOptionsFunctionCache::Reset()
+{
+	Results.Reset();
+	Previews.Reset();
+	PendingPreviews.Reset();
+	UnbindAll();
+}
+
+FNeatOptionsFunctionCache::FKey FNeatOptionsFunctionCache::MakeKey(const UClass* InOwnerClass, const FString& InFunctionName) const
+{
+	// Static functions are found by their path, so the class of the property doesn't matter.
+	return FKey { IsStaticFunctionPath(InFunctionName) ? FObjectKey() : FObjectKey(InOwnerClass), InFunctionName };
+}
+
+void FNeatOptionsFunctionCache::RemoveEntriesIf(TFunctionRef<bool(const FKey&)> Predicate)
+{
+	for (auto It = Results.CreateIterator(); It; ++It)
+	{
+		if (Predicate(It->Key))
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	// Pending previews that are removed are skipped once the ticker gets to them.
+	for (auto It = Previews.CreateIterator(); It; ++It)
+	{
+		if (Predicate(It->Key))
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+bool FNeatOptionsFunctionCache::IsStaticFunctionPath(const FString& InFunctionName)
+{
+	int32 Index;
+	return InFunctionName.FindChar(TEXT('.'), Index);
+}
+
+void FNeatOptionsFunctionCache::BindBlueprint(UBlueprint& InBlueprint)
+{
+	const FObjectKey Key(&InBlueprint);
+	if (BoundBlueprints.Contains(Key))
+	{
+		return;
+	}
+
+	FBlueprintBinding& Binding = BoundBlueprints.Add(Key);
+	Binding.Blueprint = &InBlueprint;
+	Binding.ChangedHandle = InBlueprint.OnChanged().AddRaw(this, &FNeatOptionsFunctionCache::InvalidateBlueprint);
+	Binding.CompiledHandle = InBlueprint.OnCompiled().AddRaw(this, &FNeatOptionsFunctionCache::InvalidateBlueprint);
+}
+
+void FNeatOptionsFunctionCache::InvalidateBlueprint(UBlueprint* InBlueprint)
+{
+	if (!InBlueprint)
+	{
+		return;
+	}
+
+	// Member functions may be looked up on either the skeleton or the generated class.
+	const FObjectKey GeneratedClass(InBlueprint->GeneratedClass);
+	const FObjectKey SkeletonClass(InBlueprint->SkeletonGeneratedClass);
+	RemoveEntriesIf([&](const FKey& Key) { return Key.OwnerClass == GeneratedClass || Key.OwnerClass == SkeletonClass; });
+}
+
+void FNeatOptionsFunctionCache::InvalidateStaticFunctions()
+{
+	RemoveEntriesIf([](const FKey& Key) { return Key.OwnerClass == FObjectKey(); });
+}
+
+void FNeatOptionsFunctionCache::UnbindAll()
+{
+	for (const TPair<FObjectKey, FBlueprintBinding>& Pair : BoundBlueprints)
+	{
+		if (UBlueprint* Blueprint = Pair.Value.Blueprint.Get())
+		{
+			Blueprint->OnChanged().Remove(Pair.Value.ChangedHandle);
+			Blueprint->OnCompiled().Remove(Pair.Value.CompiledHandle);
+		}
+	}
+	BoundBlueprints.Reset();
+}
+
+void FNeatOptionsFunctionCache::OnBlueprintCompiled()
+{
+	// Static functions may be defined in Blueprint function libraries, which is reported as an error.
+	InvalidateStaticFunctions();
+}
+
+void FNeatOptionsFunctionCache::OnReloadComplete(EReloadCompleteReason Reason)
+{
+	Reset();
+}
+
+void FNeatOptionsFunctionCache::OnModulesChanged(FName ModuleName, EModuleChangeReason Reason)
+{
+	if (Reason == EModuleChangeReason::ModuleLoaded)
+	{
+		Reset();
+	}
+}
+
+void FNeatOptionsFunctionCache::OnPostGarbageCollect()
+{
+	RemoveEntriesIf([](const FKey& Key) { return Key.OwnerClass != FObjectKey() && !Key.OwnerClass.ResolveObjectPtr(); });
+
+	for (auto It = BoundBlueprints.CreateIterator(); It; ++It)
+	{
+		if (!It->Value.Blueprint.IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+bool FNeatOptionsFunctionCache::TickPendingPreviews(float DeltaTime)
+{
+	// Evaluate a single function per tick, so that several slow functions can't add up to a long hitch.
+	while (!PendingPreviews.IsEmpty())
+	{
+		const FKey Key = PendingPreviews[0];
+		PendingPreviews.RemoveAt(0);
+
+		FPreview* Preview = Previews.Find(Key);
+		if (Preview && Preview->State == FPreview::EState::Pending)
+		{
+			EvaluatePreview(Key, *Preview);
+			return true;
+		}
+	}
+
+	PreviewTickerHandle.Reset();
+	return false;
+}
+
+void FNeatOptionsFunctionCache::EvaluatePreview(const FKey& InKey, FPreview& OutPreview) const
+{
+	const UNeatMetadataUserSettings* Settings = GetDefault<UNeatMetadataUserSettings>();
+	OutPreview.State = FPreview::EState::Failed;
+
+	const UFunction* Function = nullptr;
+	UObject* Context = nullptr;
+	if (InKey.OwnerClass == FObjectKey())
+	{
+		Function = FindObject<UFunction>(nullptr, *InKey.FunctionName, true);
+		Context = Function ? Function->GetOwnerClass()->GetDefaultObject() : nullptr;
+	}
+	else if (const UClass* OwnerClass = Cast<UClass>(InKey.OwnerClass.ResolveObjectPtr()))
+	{
+		// Never run script on a skeleton class, use the class that was generated when the Blueprint was last compiled.
+		if (const UBlueprint* Blueprint = Cast<UBlueprint>(OwnerClass->ClassGeneratedBy))
+		{
+			if (Blueprint->Status == BS_Error)
+			{
+				return;
+			}
+			OwnerClass = Blueprint->GeneratedClass;
+		}
+
+		if (OwnerClass)
+		{
+			Function = OwnerClass->FindFunctionByName(FName(InKey.FunctionName));
+			Context = OwnerClass->GetDefaultObject();
+		}
+	}
+
+	const FArrayProperty* ReturnProperty = Function ? CastField<FArrayProperty>(Function->GetReturnProperty()) : nullptr;
+	if (!Context || !ReturnProperty || Function->NumParms != 1)
+	{
+		return;
+	}
+
+	uint8* Params = static_cast<uint8*>(FMemory_Alloca_Aligned(Function->ParmsSize, Function->GetMinAlignment()));
+	FMemory::Memzero(Params, Function->ParmsSize);
+	ReturnProperty->InitializeValue_InContainer(Params);
+
+	const double StartTime = FPlatformTime::Seconds();
+	{
+		FEditorScriptExecutionGuard ScriptGuard;
+		Context->ProcessEvent(const_cast<UFunction*>(Function), Params);
+	}
+	OutPreview.Duration = FPlatformTime::Seconds() - StartTime;
+
+	// Script can't be interrupted, so a slow function is flagged instead, and isn't run again until it changes.
+	if (OutPreview.Duration * 1000.0 > Settings->GetOptionsPreviewBudget)
+	{
+		OutPreview.State = FPreview::EState::TooSlow;
+	}
+	else
+	{
+		FScriptArrayHelper Options(ReturnProperty, ReturnProperty->ContainerPtrToValuePtr<void>(Params));
+		OutPreview.State = FPreview::EState::Ready;
+		OutPreview.NumOptions = Options.Num();
+
+		const int32 NumToList = FMath::Min(Options.Num(), Settings->GetOptionsPreviewCount);
+		OutPreview.FirstOptions.Reset(NumToList);
+		for (int32 Index = 0; Index < NumToList; Index++)
+		{
+			FString& Option = OutPreview.FirstOptions.AddDefaulted_GetRef();
+			ReturnProperty->Inner->ExportTextItem_Direct(Option, Options.GetRawPtr(Index), nullptr, nullptr, PPF_None);
+		}
+	}
+
+	ReturnProperty->DestroyValue_InContainer(Params);
+}
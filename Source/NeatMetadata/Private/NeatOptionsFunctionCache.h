@@ -0,0 +1,121 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#pragma once
+#include "CoreMinimal.h"
+#include "Modules/ModuleManager.h"
+#include "UObject/ObjectKey.h"
+#include "Containers/Ticker.h"
+
+class UBlueprint;
+enum class EReloadCompleteReason;
+
+/**
+ * Memoizes validation results of GetOptions functions per owner class and function name, so that exporting and
+ * displaying the GetOptions metadata doesn't have to look up the function over and over.
+ *
+ * Results for a Blueprint class are discarded when that Blueprint changes or is compiled. Results for static functions,
+ * which are referenced by path, are discarded whenever any Blueprint is compiled, since the function may be defined in one.
+ * Everything is discarded after hot reload, Live Coding and module loads.
+ *
+ * The cache also holds previews of the options that functions return. Previews are evaluated on a later tick, one at a
+ * time, and functions that exceed the time budget are not evaluated again until their results are discarded.
+ */
+class FNeatOptionsFunctionCache
+{
+public:
+	static FNeatOptionsFunctionCache& Get();
+	static void TearDown();
+
+	~FNeatOptionsFunctionCache();
+
+	using FValidateSignature = TOptional<FString>();
+	/**
+	 * @brief Finds the cached validation result for a function, validating it if there is no cached result.
+	 * @param InOwnerClass The class that member functions are looked up in. Ignored for static functions.
+	 * @param InFunctionName The name of a member function, or the path of a static function.
+	 * @param Validate Validates the function if there is no cached result.
+	 * @return The error message, if the function isn't valid.
+	 */
+	TOptional<FString> FindOrValidate(const UClass* InOwnerClass, const FString& InFunctionName, TFunctionRef<FValidateSignature> Validate);
+
+	struct FPreview
+	{
+		enum class EState : uint8
+		{
+			Pending,
+			Ready,
+			TooSlow,
+			Failed,
+		};
+
+		EState State = EState::Pending;
+		int32 NumOptions = 0;
+		TArray<FString> FirstOptions;
+		double Duration = 0.0;
+	};
+
+	/**
+	 * @brief Finds the preview of the options returned by a function, requesting it if there is none.
+	 * The function must have been validated successfully.
+	 * @param InOwnerClass The class that member functions are looked up in. Ignored for static functions.
+	 * @param InFunctionName The name of a member function, or the path of a static function.
+	 * @return The preview, which is pending until it has been evaluated. Only valid until the cache is modified.
+	 */
+	const FPreview& FindOrRequestPreview(const UClass* InOwnerClass, const FString& InFunctionName);
+
+	// Discards all cached results.
+	void Reset();
+
+private:
+	FNeatOptionsFunctionCache();
+
+	static bool IsStaticFunctionPath(const FString& InFunctionName);
+
+	struct FKey
+	{
+		FObjectKey OwnerClass;
+		FString FunctionName;
+
+		bool operator==(const FKey& Other) const { return OwnerClass == Other.OwnerClass && FunctionName.Equals(Other.FunctionName, ESearchCase::CaseSensitive); }
+		friend uint32 GetTypeHash(const FKey& Key) { return HashCombine(GetTypeHash(Key.OwnerClass), GetTypeHash(Key.FunctionName)); }
+	};
+
+	struct FBlueprintBinding
+	{
+		TWeakObjectPtr<UBlueprint> Blueprint;
+		FDelegateHandle ChangedHandle;
+		FDelegateHandle CompiledHandle;
+	};
+
+	FKey MakeKey(const UClass* InOwnerClass, const FString& InFunctionName) const;
+	void RemoveEntriesIf(TFunctionRef<bool(const FKey&)> Predicate);
+
+	bool TickPendingPreviews(float DeltaTime);
+	void EvaluatePreview(const FKey& InKey, FPreview& OutPreview) const;
+
+	void BindBlueprint(UBlueprint& InBlueprint);
+	void InvalidateBlueprint(UBlueprint* InBlueprint);
+	void InvalidateStaticFunctions();
+	void UnbindAll();
+
+	void OnBlueprintCompiled();
+	void OnReloadComplete(EReloadCompleteReason Reason);
+	void OnModulesChanged(FName ModuleName, EModuleChangeReason Reason);
+	void OnPostGarbageCollect();
+
+	TMap<FKey, TOptional<FString>> Results;
+	TMap<FObjectKey, FBlueprintBinding> BoundBlueprints;
+
+	TMap<FKey, FPreview> Previews;
+	TArray<FKey> PendingPreviews;
+	FTSTicker::FDelegateHandle PreviewTickerHandle;
+
+	FDelegateHandle BlueprintCompiledHandle;
+	FDelegateHandle ReloadCompleteHandle;
+	FDelegateHandle ModulesChangedHandle;
+	FDelegateHandle PostGarbageCollectHandle;
+#if WITH_LIVE_CODING
+	FDelegateHandle LiveCodingPatchCompleteHandle;
+#endif
+
+	static TUniquePtr<FNeatOptionsFunctionCache> Instance;
+};
@@ -0,0 +1,148 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#include "NeatRowStructCatalog.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "DataTableEditorUtils.h"
+#include "Engine/DataTable.h"
+#include "Engine/UserDefinedStruct.h"
+
+namespace
+{
+	const FName RowStructureTag("RowStructure");
+}
+
+TUniquePtr<FNeatRowStructCatalog> FNeatRowStructCatalog::Instance;
+
+FNeatRowStructCatalog& FNeatRowStructCatalog::Get()
+{
+	if (!Instance)
+	{
+		Instance = TUniquePtr<FNeatRowStructCatalog>(new FNeatRowStructCatalog());
+	}
+	return *Instance;
+}
+
+void FNeatRowStructCatalog::TearDown()
+{
+	Instance.Reset();
+}
+
+FNeatRowStructCatalog::FNeatRowStructCatalog()
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(AssetRegistryConstants::ModuleName).Get();
+	AssetAddedHandle = AssetRegistry.OnAssetAdded().AddRaw(this, &FNeatRowStructCatalog::OnAssetChanged);
+	AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddRaw(this, &FNeatRowStructCatalog::OnAssetChanged);
+	AssetUpdatedHandle = AssetRegistry.OnAssetUpdated().AddRaw(this, &FNeatRowStructCatalog::OnAssetChanged);
+	AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddRaw(this, &FNeatRowStructCatalog::OnAssetRenamed);
+	FilesLoadedHandle = AssetRegistry.OnFilesLoaded().AddRaw(this, &FNeatRowStructCatalog::MarkDirty);
+	
+	ModulesChangedHandle = FModuleManager::Get().OnModulesChanged().AddRaw(this, &FNeatRowStructCatalog::OnModulesChanged);
+}
+
+FNeatRowStructCatalog::~FNeatRowStructCatalog()
+{
+	if (FModuleManager* ModuleManager = FModuleManager::GetModuleManagerIfExists())
+	{
+		ModuleManager->OnModulesChanged().Remove(ModulesChangedHandle);
+	}
+	if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>(AssetRegistryConstants::ModuleName))
+	{
+		AssetRegistryModule->Get().OnAssetAdded().Remove(AssetAddedHandle);
+		AssetRegistryModule->Get().OnAssetRemoved().Remove(AssetRemovedHandle);
+		AssetRegistryModule->Get().OnAssetUpdated().Remove(AssetUpdatedHandle);
+		AssetRegistryModule->Get().OnAssetRenamed().Remove(AssetRenamedHandle);
+		AssetRegistryModule->Get().OnFilesLoaded().Remove(FilesLoadedHandle);
+	}
+}
+
+TConstArrayView<FNeatRowStructCatalog::FEntry> FNeatRowStructCatalog::GetEntries()
+{
+	RebuildIfDirty();
+	return Entries;
+}
+
+uint32 FNeatRowStructCatalog::GetGeneration()
+{
+	RebuildIfDirty();
+	return Generation;
+}
+
+void FNeatRowStructCatalog::RebuildIfDirty()
+{
+	if (!bDirty)
+	{
+		return;
+	}
+
+	bDirty = false;
+	Generation++;
+	Entries.Reset();
+
+	// Count DataTables per row struct. Older assets may only store the name of the struct, not its path.
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(AssetRegistryConstants::ModuleName).Get();
+	TMap<FString, int32> DataTablesPerStruct;
+	FARFilter DataTableFilter;
+	DataTableFilter.ClassPaths.Add(UDataTable::StaticClass()->GetClassPathName());
+	DataTableFilter.bRecursiveClasses = true;
+	AssetRegistry.EnumerateAssets(DataTableFilter, [&](const FAssetData& AssetData)
+	{
+		FString RowStructure;
+		if (AssetData.GetTagValue(RowStructureTag, RowStructure) && !RowStructure.IsEmpty())
+		{
+			DataTablesPerStruct.FindOrAdd(FPackageName::ExportTextPathToObjectPath(RowStructure))++;
+		}
+		return true;
+	});
+
+	TArray<FAssetData> StructAssets;
+	FDataTableEditorUtils::GetPossibleStructAssetData(StructAssets);
+	Entries.Reserve(StructAssets.Num());
+	for (const FAssetData& Asset : StructAssets)
+	{
+		FEntry& Entry = Entries.AddDefaulted_GetRef();
+		Entry.Path = Asset.GetSoftObjectPath().GetAssetPathString();
+		Entry.DisplayName = FText::FromName(Asset.AssetName);
+
+		const int32* ByPath = DataTablesPerStruct.Find(Entry.Path);
+		const int32* ByName = DataTablesPerStruct.Find(Asset.AssetName.ToString());
+		Entry.NumDataTables = (ByPath ? *ByPath : 0) + (ByName ? *ByName : 0);
+	}
+
+	Entries.Sort([](const FEntry& A, const FEntry& B)
+	{
+		return A.DisplayName.CompareTo(B.DisplayName) < 0;
+	});
+}
+
+void FNeatRowStructCatalog::MarkDirty()
+{
+	bDirty = true;
+}
+
+bool FNeatRowStructCatalog::IsRelevantAsset(const FAssetData& InAssetData)
+{
+	const UClass* AssetClass = InAssetData.GetClass();
+	return AssetClass && (AssetClass->IsChildOf<UDataTable>() || AssetClass->IsChildOf<UUserDefinedStruct>());
+}
+
+void FNeatRowStructCatalog::OnAssetChanged(const FAssetData& InAssetData)
+{
+	if (IsRelevantAsset(InAssetData))
+	{
+		MarkDirty();
+	}
+}
+
+void FNeatRowStructCatalog::OnAssetRenamed(const FAssetData& InAssetData, const FString& InOldObjectPath)
+{
+	OnAssetChanged(InAssetData);
+}
+
+void FNeatRowStructCatalog::OnModulesChanged(FName ModuleName, EModuleChangeReason Reason)
+{
+	// Modules may add native row structs.
+	if (Reason == EModuleChangeReason::ModuleLoaded)
+	{
+		MarkDirty();
+	}
+}
@@ -0,0 +1,62 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#pragma once
+#include "CoreMinimal.h"
+#include "Modules/ModuleManager.h"
+
+struct FAssetData;
+
+/**
+ * Cached list of all structs that can be used as DataTable row structs, together with how many DataTables use each of
+ * them. Counts are taken from the asset registry tags of the DataTables, so nothing is loaded.
+ *
+ * The catalog is rebuilt lazily, the next time it is used after a relevant asset has been added, removed, renamed or
+ * updated, or after a module has been loaded.
+ */
+class FNeatRowStructCatalog
+{
+public:
+	static FNeatRowStructCatalog& Get();
+	static void TearDown();
+
+	~FNeatRowStructCatalog();
+
+	struct FEntry
+	{
+		// The path of the struct, which is what is stored in the RowType metadata.
+		FString Path;
+		FText DisplayName;
+		int32 NumDataTables = 0;
+	};
+
+	/**
+	 * @brief All possible row structs, sorted by display name.
+	 */
+	TConstArrayView<FEntry> GetEntries();
+
+	// Changes whenever the catalog has been rebuilt.
+	uint32 GetGeneration();
+
+private:
+	FNeatRowStructCatalog();
+
+	void RebuildIfDirty();
+	void MarkDirty();
+	static bool IsRelevantAsset(const FAssetData& InAssetData);
+
+	void OnAssetChanged(const FAssetData& InAssetData);
+	void OnAssetRenamed(const FAssetData& InAssetData, const FString& InOldObjectPath);
+	void OnModulesChanged(FName ModuleName, EModuleChangeReason Reason);
+
+	TArray<FEntry> Entries;
+	uint32 Generation = 0;
+	bool bDirty = true;
+
+	FDelegateHandle AssetAddedHandle;
+	FDelegateHandle AssetRemovedHandle;
+	FDelegateHandle AssetRenamedHandle;
+	FDelegateHandle AssetUpdatedHandle;
+	FDelegateHandle FilesLoadedHandle;
+	FDelegateHandle ModulesChangedHandle;
+
+	static TUniquePtr<FNeatRowStructCatalog> Instance;
+};
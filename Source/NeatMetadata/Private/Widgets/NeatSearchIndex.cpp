@@ -0,0 +1,222 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#include "NeatSearchIndex.h"
+#include "String/Find.h"
+
+namespace
+{
+	// Matches in the name and display name are worth more than matches in the tooltip.
+	constexpr int32 FieldWeights[] = { 3, 3, 1 };
+	
+	constexpr int32 PrefixBonus = 300;
+	constexpr int32 SubstringBonus = 150;
+	constexpr int32 WordStartBonus = 8;
+	constexpr int32 ConsecutiveBonus = 4;
+}
+
+void FNeatSearchIndex::Reset()
+{
+	Entries.Reset();
+	LastMatches.Reset();
+	bHasLastQuery = false;
+}
+
+int32 FNeatSearchIndex::Add(const FString& InName, const FString& InDisplayName, const FString& InToolTip)
+{
+	FEntry& Entry = Entries.AddDefaulted_GetRef();
+	Entry.Fields[0] = MakeField(InName);
+	Entry.Fields[1] = MakeField(InDisplayName);
+	Entry.Fields[2] = MakeField(InToolTip);
+
+	for (const FField& Field : Entry.Fields)
+	{
+		for (const TCHAR Char : Field.Lower)
+		{
+			Entry.CharacterMask |= GetCharacterBit(Char);
+		}
+	}
+
+	// The new entry hasn't been scored against the last query.
+	bHasLastQuery = false;
+	return Entries.Num() - 1;
+}
+
+void FNeatSearchIndex::Search(const FString& InQuery, TArray<FResult>& OutResults)
+{
+	OutResults.Reset();
+
+	const FString Query = InQuery.ToLower();
+	TArray<FStringView, TInlineAllocator<8>> Tokens;
+	uint64 QueryMask = 0;
+	{
+		int32 TokenStart = INDEX_NONE;
+		for (int32 Idx = 0; Idx <= Query.Len(); Idx++)
+		{
+			const bool bIsSeparator = Idx == Query.Len() || FChar::IsWhitespace(Query[Idx]);
+			if (!bIsSeparator)
+			{
+				QueryMask |= GetCharacterBit(Query[Idx]);
+				TokenStart = TokenStart == INDEX_NONE ? Idx : TokenStart;
+			}
+			else if (TokenStart != INDEX_NONE)
+			{
+				Tokens.Add(FStringView(*Query + TokenStart, Idx - TokenStart));
+				TokenStart = INDEX_NONE;
+			}
+		}
+	}
+
+	// Appending to a query can only remove matches, so only the previous matches need to be looked at.
+	const bool bNarrowing = bHasLastQuery && Query.StartsWith(LastQuery, ESearchCase::CaseSensitive);
+	TArray<int32> Matches;
+	auto TestEntry = [&](int32 Id)
+	{
+		const FEntry& Entry = Entries[Id];
+		if ((Entry.CharacterMask & QueryMask) != QueryMask)
+		{
+			return;
+		}
+
+		const int32 Score = ScoreEntry(Entry, Tokens);
+		if (Score >= 0)
+		{
+			Matches.Add(Id);
+			OutResults.Add({ Id, Score });
+		}
+	};
+
+	if (bNarrowing)
+	{
+		for (const int32 Id : LastMatches)
+		{
+			TestEntry(Id);
+		}
+	}
+	else
+	{
+		for (int32 Id = 0; Id < Entries.Num(); Id++)
+		{
+			TestEntry(Id);
+		}
+	}
+
+	LastQuery = Query;
+	LastMatches = MoveTemp(Matches);
+	bHasLastQuery = true;
+
+	OutResults.Sort([](const FResult& A, const FResult& B)
+	{
+		return A.Score != B.Score ? A.Score > B.Score : A.Id < B.Id;
+	});
+}
+
+FNeatSearchIndex::FField FNeatSearchIndex::MakeField(const FString& InText)
+{
+	FField Field;
+	Field.Lower = InText.ToLower();
+	Field.WordStarts.Init(false, InText.Len());
+
+	for (int32 Idx = 0; Idx < InText.Len(); Idx++)
+	{
+		const TCHAR Char = InText[Idx];
+		if (!FChar::IsAlnum(Char))
+		{
+			continue;
+		}
+
+		const TCHAR Previous = Idx > 0 ? InText[Idx - 1] : TEXT(' ');
+		const bool bAfterSeparator = !FChar::IsAlnum(Previous);
+		const bool bCamelCase = FChar::IsUpper(Char) && FChar::IsLower(Previous);
+		const bool bDigitStart = FChar::IsDigit(Char) && !FChar::IsDigit(Previous);
+		Field.WordStarts[Idx] = bAfterSeparator || bCamelCase || bDigitStart;
+	}
+
+	return Field;
+}
+
+uint64 FNeatSearchIndex::GetCharacterBit(TCHAR InChar)
+{
+	if (InChar >= TEXT('a') && InChar <= TEXT('z'))
+	{
+		return 1ull << (InChar - TEXT('a'));
+	}
+
+	if (InChar >= TEXT('0') && InChar <= TEXT('9'))
+	{
+		return 1ull << (26 + InChar - TEXT('0'));
+	}
+
+	// Other characters get no bit, so they never rule out an entry.
+	return 0;
+}
+
+int32 FNeatSearchIndex::ScoreToken(const FField& InField, FStringView InToken)
+{
+	const FString& Text = InField.Lower;
+	if (InToken.Len() > Text.Len())
+	{
+		return INDEX_NONE;
+	}
+
+	// Whole substrings are preferred over scattered characters.
+	const int32 SubstringIndex = UE::String::FindFirst(Text, InToken, ESearchCase::CaseSensitive);
+	if (SubstringIndex == 0)
+	{
+		// Prefer the entry that the token covers the most of.
+		return FMath::Max(1, PrefixBonus + InToken.Len() * ConsecutiveBonus - (Text.Len() - InToken.Len()));
+	}
+
+	if (SubstringIndex != INDEX_NONE)
+	{
+		const int32 WordStart = InField.WordStarts[SubstringIndex] ? WordStartBonus * 4 : 0;
+		return FMath::Max(1, SubstringBonus + WordStart + InToken.Len() * ConsecutiveBonus - SubstringIndex);
+	}
+
+	// Greedy subsequence match, rewarding characters that start words or follow the previous match.
+	int32 Score = 0;
+	int32 TextIdx = 0;
+	int32 PreviousMatch = INDEX_NONE;
+	for (const TCHAR TokenChar : InToken)
+	{
+		while (TextIdx < Text.Len() && Text[TextIdx] != TokenChar)
+		{
+			TextIdx++;
+		}
+
+		if (TextIdx == Text.Len())
+		{
+			return INDEX_NONE;
+		}
+
+		Score += 1;
+		Score += InField.WordStarts[TextIdx] ? WordStartBonus : 0;
+		Score += PreviousMatch == TextIdx - 1 ? ConsecutiveBonus : 0;
+		PreviousMatch = TextIdx++;
+	}
+
+	return Score;
+}
+
+int32 FNeatSearchIndex::ScoreEntry(const FEntry& InEntry, TConstArrayView<FStringView> InTokens) const
+{
+	int32 TotalScore = 0;
+	for (const FStringView& Token : InTokens)
+	{
+		int32 BestScore = INDEX_NONE;
+		for (int32 FieldIdx = 0; FieldIdx < FEntry::NumFields; FieldIdx++)
+		{
+			const int32 Score = ScoreToken(InEntry.Fields[FieldIdx], Token);
+			if (Score != INDEX_NONE)
+			{
+				BestScore = FMath::Max(BestScore, Score * FieldWeights[FieldIdx]);
+			}
+		}
+
+		if (BestScore == INDEX_NONE)
+		{
+			return INDEX_NONE;
+		}
+		TotalScore += BestScore;
+	}
+
+	return TotalScore;
+}
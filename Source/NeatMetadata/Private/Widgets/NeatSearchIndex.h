@@ -0,0 +1,65 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+#pragma once
+#include "CoreMinimal.h"
+
+/**
+ * Small search engine for the selector widgets. Entries are added once with a name, a display name and a tooltip, which
+ * are lowercased and analyzed up front. Queries are split into whitespace separated tokens, and every token has to match
+ * one of the fields of an entry as a subsequence. Matches are ranked so that prefixes, whole substrings and matches at
+ * word starts come first.
+ *
+ * Queries that extend the previous query only rescore the entries that matched last time, which is the common case while
+ * typing.
+ */
+class FNeatSearchIndex
+{
+public:
+	struct FResult
+	{
+		int32 Id = INDEX_NONE;
+		int32 Score = 0;
+	};
+
+	void Reset();
+
+	/**
+	 * @brief Adds an entry to the index.
+	 * @return The id of the entry, which is its index in insertion order.
+	 */
+	int32 Add(const FString& InName, const FString& InDisplayName, const FString& InToolTip);
+
+	int32 Num() const { return Entries.Num(); }
+
+	/**
+	 * @brief Finds all entries that match the query.
+	 * @param InQuery The text to search for.
+	 * @param OutResults The matching entries, best match first.
+	 */
+	void Search(const FString& InQuery, TArray<FResult>& OutResults);
+
+private:
+	struct FField
+	{
+		FString Lower;
+		TBitArray<> WordStarts;
+	};
+
+	struct FEntry
+	{
+		static constexpr int32 NumFields = 3;
+		FField Fields[NumFields];
+		// One bit per letter and digit that occurs in any field. Entries that lack a character of the query can't match.
+		uint64 CharacterMask = 0;
+	};
+
+	static FField MakeField(const FString& InText);
+	static uint64 GetCharacterBit(TCHAR InChar);
+	static int32 ScoreToken(const FField& InField, FStringView InToken);
+	int32 ScoreEntry(const FEntry& InEntry, TConstArrayView<FStringView> InTokens) const;
+
+	TArray<FEntry> Entries;
+
+	FString LastQuery;
+	TArray<int32> LastMatches;
+	bool bHasLastQuery = false;
+};
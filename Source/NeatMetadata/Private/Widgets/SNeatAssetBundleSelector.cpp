@@ -0,0 +1,248 @@
+﻿// Copyright Viktor Pramberg. All Rights Reserved.
+#include "SNeatAssetBundleSelector.h"
+#include "NeatAssetBundleIndex.h"
+
+#include "DetailLayoutBuilder.h"
+#include "PropertyHandle.h"
+#include "Styling/StyleColors.h"
+#include "Widgets/Layout/SWrapBox.h"
+
+struct FNeatAssetBundleSelectorItem
+{
+	FString Name;
+	int32 NumProperties = 0;
+	int32 NumAssets = 0;
+	// Whether this item adds a bundle that isn't used anywhere yet.
+	bool bIsNew = false;
+};
+
+namespace
+{
+	FText GetUsageText(int32 InNumProperties, int32 InNumAssets)
+	{
+		return FText::Format(INVTEXT("Declared by {0} {0}|plural(one=property,other=properties), and used by {1} {1}|plural(one=asset,other=assets)."), InNumProperties, InNumAssets);
+	}
+}
+
+void SNeatAssetBundleSelector::Construct(const FArguments&, TSharedRef<IPropertyHandle> InArrayHandle)
+{
+	ArrayHandle = InArrayHandle;
+
+	const FSimpleDelegate OnBundlesChanged = FSimpleDelegate::CreateSP(this, &SNeatAssetBundleSelector::RebuildBundles);
+	ArrayHandle->SetOnPropertyValueChanged(OnBundlesChanged);
+	ArrayHandle->SetOnChildPropertyValueChanged(OnBundlesChanged);
+	if (const TSharedPtr<IPropertyHandleArray> Array = ArrayHandle->AsArray())
+	{
+		Array->SetOnNumElementsChanged(OnBundlesChanged);
+	}
+
+	ChildSlot
+	[
+		SNew(SVerticalBox)
+		+SVerticalBox::Slot()
+		.AutoHeight()
+		[
+			SAssignNew(BundlesBox, SWrapBox)
+			.UseAllottedSize(true)
+		]
+		+SVerticalBox::Slot()
+		.AutoHeight()
+		.HAlign(HAlign_Left)
+		.Padding(0.0f, 2.0f)
+		[
+			SNew(SNeatCatalogSelector<FNeatAssetBundleSelectorItem>)
+			.MenuWidth(300.0f)
+			.HintText(INVTEXT("Search, or type a new bundle name"))
+			.Generation_Lambda([]() { return FNeatAssetBundleIndex::Get().GetGeneration(); })
+			.OnRefreshItems(this, &SNeatAssetBundleSelector::OnRefreshItems)
+			.OnFilterItems(this, &SNeatAssetBundleSelector::OnFilterItems)
+			.OnGenerateItem(this, &SNeatAssetBundleSelector::OnGenerateItem)
+			.OnItemPicked(this, &SNeatAssetBundleSelector::OnItemPicked)
+			.ButtonContent()
+			[
+				SNew(STextBlock)
+				.Text(INVTEXT("Add Bundle"))
+				.Font(IDetailLayoutBuilder::GetDetailFont())
+			]
+			.MenuHeader()
+			[
+				SNew(STextBlock)
+				.Visibility_Lambda([]() { return FNeatAssetBundleIndex::Get().IsBuilding() ? EVisibility::Visible : EVisibility::Collapsed; })
+				.Margin(FMargin(4.0f, 0.0f))
+				.Text(INVTEXT("Gathering bundles..."))
+				.ColorAndOpacity(FSlateColor::UseSubduedForeground())
+				.Font(IDetailLayoutBuilder::GetDetailFontItalic())
+			]
+		]
+	];
+
+	RebuildBundles();
+}
+
+void SNeatAssetBundleSelector::RebuildBundles()
+{
+	BundlesBox->ClearChildren();
+
+	const TArray<FString> Bundles = GetBundles();
+	for (int32 Index = 0; Index < Bundles.Num(); Index++)
+	{
+		const FName BundleName(Bundles[Index]);
+
+		// The index may still be building, so look up the entry each time the bundle is painted.
+		BundlesBox->AddSlot()
+		.Padding(0.0f, 2.0f, 4.0f, 2.0f)
+		[
+			SNew(SBorder)
+			.BorderImage(FAppStyle::GetBrush(TEXT("ToolPanel.DarkGroupBorder")))
+			.Padding(FMargin(6.0f, 2.0f, 2.0f, 2.0f))
+			.ToolTipText_Lambda([BundleName]()
+			{
+				const FNeatAssetBundleIndex::FEntry* Entry = FNeatAssetBundleIndex::Get().FindEntry(BundleName);
+				return Entry ? GetUsageText(Entry->NumProperties, Entry->NumAssets) : INVTEXT("No primary data asset uses this bundle.");
+			})
+			[
+				SNew(SHorizontalBox)
+				+SHorizontalBox::Slot()
+				.AutoWidth()
+				.VAlign(VAlign_Center)
+				[
+					SNew(STextBlock)
+					.Text(FText::FromString(Bundles[Index]))
+					.Font(IDetailLayoutBuilder::GetDetailFont())
+					.ColorAndOpacity_Lambda([BundleName]()
+					{
+						// Bundles that nothing else uses are likely typos.
+						return FNeatAssetBundleIndex::Get().FindEntry(BundleName) ? FSlateColor::UseForeground() : FStyleColors::Warning;
+					})
+				]
+				+SHorizontalBox::Slot()
+				.AutoWidth()
+				.VAlign(VAlign_Center)
+				[
+					SNew(SButton)
+					.ButtonStyle(FAppStyle::Get(), TEXT("SimpleButton"))
+					.ToolTipText(INVTEXT("Remove this bundle."))
+					.OnClicked_Lambda([this, Index]()
+					{
+						RemoveBundle(Index);
+						return FReply::Handled();
+					})
+					[
+						SNew(SImage)
+						.Image(FAppStyle::GetBrush(TEXT("Icons.X")))
+						.ColorAndOpacity(FSlateColor::UseForeground())
+					]
+				]
+			]
+		];
+	}
+}
+
+TArray<FString> SNeatAssetBundleSelector::GetBundles() const
+{
+	TArray<FString> Bundles;
+
+	const TSharedPtr<IPropertyHandleArray> Array = ArrayHandle->AsArray();
+	uint32 NumElements = 0;
+	if (!Array || Array->GetNumElements(NumElements) != FPropertyAccess::Success)
+	{
+		return Bundles;
+	}
+
+	Bundles.Reserve(NumElements);
+	for (uint32 Index = 0; Index < NumElements; Index++)
+	{
+		FString& Bundle = Bundles.AddDefaulted_GetRef();
+		Array->GetElement(Index)->GetValue(Bundle);
+	}
+	return Bundles;
+}
+
+void SNeatAssetBundleSelector::AddBundle(const FString& InBundle)
+{
+	const FString Bundle = InBundle.TrimStartAndEnd();
+	const TSharedPtr<IPropertyHandleArray> Array = ArrayHandle->AsArray();
+	if (Bundle.IsEmpty() || !Array || GetBundles().Contains(Bundle))
+	{
+		return;
+	}
+
+	uint32 NumElements = 0;
+	Array->AddItem();
+	Array->GetNumElements(NumElements);
+	Array->GetElement(NumElements - 1)->SetValue(Bundle);
+}
+
+void SNeatAssetBundleSelector::RemoveBundle(int32 InIndex)
+{
+	if (const TSharedPtr<IPropertyHandleArray> Array = ArrayHandle->AsArray())
+	{
+		Array->DeleteItem(InIndex);
+	}
+}
+
+void SNeatAssetBundleSelector::OnRefreshItems(TArray<FNeatAssetBundleSelectorItemPtr>& OutItems, FNeatSearchIndex& OutSearchIndex)
+{
+	const TConstArrayView<FNeatAssetBundleIndex::FEntry> Entries = FNeatAssetBundleIndex::Get().GetEntries();
+	OutItems.Reserve(Entries.Num());
+	KnownBundles.Reset();
+	for (const FNeatAssetBundleIndex::FEntry& Entry : Entries)
+	{
+		FNeatAssetBundleSelectorItemPtr& Item = OutItems.Add_GetRef(MakeShared<FNeatAssetBundleSelectorItem>());
+		Item->Name = Entry.Name.ToString();
+		Item->NumProperties = Entry.NumProperties;
+		Item->NumAssets = Entry.NumAssets;
+		OutSearchIndex.Add(Item->Name, FString(), FString());
+		KnownBundles.Add(Item->Name);
+	}
+}
+
+void SNeatAssetBundleSelector::OnFilterItems(const FString& InSearch, TArray<FNeatAssetBundleSelectorItemPtr>& InOutItems) const
+{
+	const TArray<FString> Bundles = GetBundles();
+	InOutItems.RemoveAll([&Bundles](const FNeatAssetBundleSelectorItemPtr& Item) { return Bundles.Contains(Item->Name); });
+
+	// Offer to add the typed name, unless it is already a known bundle. TSet compares strings case insensitively.
+	if (!InSearch.IsEmpty() && !KnownBundles.Contains(InSearch))
+	{
+		FNeatAssetBundleSelectorItemPtr& NewBundleItem = InOutItems.Add_GetRef(MakeShared<FNeatAssetBundleSelectorItem>());
+		NewBundleItem->Name = InSearch;
+		NewBundleItem->bIsNew = true;
+	}
+}
+
+TSharedRef<SWidget> SNeatAssetBundleSelector::OnGenerateItem(FNeatAssetBundleSelectorItemPtr InItem, const TAttribute<FText>& InHighlightText) const
+{
+	const FText CountText = InItem->bIsNew ? INVTEXT("New") : FText::AsNumber(InItem->NumAssets);
+	const FText CountToolTip = InItem->bIsNew
+		? INVTEXT("No primary data asset uses this bundle yet, check the spelling before adding it.")
+		: GetUsageText(InItem->NumProperties, InItem->NumAssets);
+
+	return SNew(SHorizontalBox)
+		.ToolTipText(CountToolTip)
+		+SHorizontalBox::Slot()
+		.FillWidth(1.0f)
+		.VAlign(VAlign_Center)
+		.Padding(0.0f, 3.0f, 6.0f, 3.0f)
+		[
+			SNew(STextBlock)
+			.Text(FText::FromString(InItem->Name))
+			.HighlightText(InHighlightText)
+			.Font(IDetailLayoutBuilder::GetDetailFont())
+		]
+		+SHorizontalBox::Slot()
+		.AutoWidth()
+		.VAlign(VAlign_Center)
+		.Padding(6.0f, 3.0f, 0.0f, 3.0f)
+		[
+			SNew(STextBlock)
+			.Text(CountText)
+			.ColorAndOpacity(InItem->bIsNew ? FStyleColors::Warning : FSlateColor::UseSubduedForeground())
+			.Font(IDetailLayoutBuilder::GetDetailFontItalic())
+		];
+}
+
+void SNeatAssetBundleSelector::OnItemPicked(FNeatAssetBundleSelectorItemPtr InItem)
+{
+	AddBundle(InItem->Name);
+}
@@ -0,0 +1,39 @@
+﻿// Copyright Viktor Pramberg. All Rights Reserved.
+#pragma once
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/DeclarativeSyntaxSupport.h"
+#include "Internationalization/Text.h"
+#include "SNeatCatalogSelector.h"
+
+class IPropertyHandle;
+class SWrapBox;
+
+// FNeatAssetBundleSelectorItem is in the cpp file.
+using FNeatAssetBundleSelectorItemPtr = TSharedPtr<struct FNeatAssetBundleSelectorItem>;
+
+// Widget that edits an array of asset bundle names, and suggests bundles that are already used by primary data assets.
+class SNeatAssetBundleSelector : public SCompoundWidget
+{
+	SLATE_BEGIN_ARGS(SNeatAssetBundleSelector) {}
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments&, TSharedRef<IPropertyHandle> InArrayHandle);
+
+protected:
+	void RebuildBundles();
+	TArray<FString> GetBundles() const;
+	void AddBundle(const FString& InBundle);
+	void RemoveBundle(int32 InIndex);
+
+	void OnRefreshItems(TArray<FNeatAssetBundleSelectorItemPtr>& OutItems, FNeatSearchIndex& OutSearchIndex);
+	void OnFilterItems(const FString& InSearch, TArray<FNeatAssetBundleSelectorItemPtr>& InOutItems) const;
+	TSharedRef<SWidget> OnGenerateItem(FNeatAssetBundleSelectorItemPtr InItem, const TAttribute<FText>& InHighlightText) const;
+	void OnItemPicked(FNeatAssetBundleSelectorItemPtr InItem);
+
+private:
+	TSharedPtr<IPropertyHandle> ArrayHandle;
+	TSharedPtr<SWrapBox> BundlesBox;
+
+	// Bundle names known to the index, to tell whether the search text is a new bundle.
+	TSet<FString> KnownBundles;
+};
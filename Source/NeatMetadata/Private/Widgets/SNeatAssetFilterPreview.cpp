@@ -0,0 +1,114 @@
+﻿// Copyright Viktor Pramberg. All Rights Reserved.
+#include "SNeatAssetFilterPreview.h"
+
+#include "DetailLayoutBuilder.h"
+#include "Widgets/SBoxPanel.h"
+#include "Widgets/Text/STextBlock.h"
+
+namespace
+{
+	// How long the filter has to stay the same before a query is started.
+	constexpr double DebounceSeconds = 0.3;
+}
+
+void SNeatAssetFilterPreview::Construct(const FArguments& InArgs)
+{
+	GetParams = InArgs._GetParams;
+	NumSamples = InArgs._NumSamples;
+
+	ChildSlot
+	[
+		SNew(SVerticalBox)
+		+SVerticalBox::Slot()
+		.AutoHeight()
+		[
+			SNew(STextBlock)
+			.Text(this, &SNeatAssetFilterPreview::GetSummaryText)
+			.Font(IDetailLayoutBuilder::GetDetailFont())
+		]
+		+SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(8.0f, 2.0f, 0.0f, 0.0f)
+		[
+			SAssignNew(SamplesBox, SVerticalBox)
+		]
+	];
+}
+
+SNeatAssetFilterPreview::~SNeatAssetFilterPreview()
+{
+	if (Query)
+	{
+		Query->Cancel();
+	}
+}
+
+void SNeatAssetFilterPreview::Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime)
+{
+	SCompoundWidget::Tick(AllottedGeometry, InCurrentTime, InDeltaTime);
+
+	if (GetParams.IsBound())
+	{
+		FNeatAssetFilterQueryParams NewParams = GetParams.Execute();
+		if (!bHasParams || NewParams != Params)
+		{
+			// Rapid edits keep pushing the query back, and a query for an outdated filter is of no use.
+			Params = MoveTemp(NewParams);
+			bHasParams = true;
+			LaunchTime = InCurrentTime + DebounceSeconds;
+			if (Query)
+			{
+				Query->Cancel();
+				Query.Reset();
+			}
+		}
+	}
+
+	if (LaunchTime > 0.0 && InCurrentTime >= LaunchTime)
+	{
+		LaunchTime = 0.0;
+		LaunchQuery();
+	}
+
+	if (Query && Query->IsDone())
+	{
+		OnQueryDone();
+	}
+}
+
+void SNeatAssetFilterPreview::LaunchQuery()
+{
+	Query = FNeatAssetFilterQuery::Launch(Params, NumSamples);
+}
+
+void SNeatAssetFilterPreview::OnQueryDone()
+{
+	Result = Query->GetResult();
+	Query.Reset();
+
+	SamplesBox->ClearChildren();
+	for (const FSoftObjectPath& Sample : Result->Samples)
+	{
+		SamplesBox->AddSlot()
+		.AutoHeight()
+		[
+			SNew(STextBlock)
+			.Text(FText::FromString(Sample.GetAssetName()))
+			.ToolTipText(FText::FromString(Sample.ToString()))
+			.ColorAndOpacity(FSlateColor::UseSubduedForeground())
+			.Font(IDetailLayoutBuilder::GetDetailFontItalic())
+		];
+	}
+}
+
+FText SNeatAssetFilterPreview::GetSummaryText() const
+{
+	const bool bIsPending = Query.IsValid() || LaunchTime > 0.0;
+	if (!Result)
+	{
+		return bIsPending ? INVTEXT("Counting assets...") : FText::GetEmpty();
+	}
+
+	const FText Summary = FText::Format(INVTEXT("{0} matching {0}|plural(one=asset,other=assets)"), Result->NumAssets);
+	return bIsPending ? FText::Format(INVTEXT("{0} (updating...)"), Summary) : Summary;
+}
@@ -0,0 +1,44 @@
+﻿// Copyright Viktor Pramberg. All Rights Reserved.
+#pragma once
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/DeclarativeSyntaxSupport.h"
+#include "NeatAssetFilterQuery.h"
+
+class SVerticalBox;
+
+DECLARE_DELEGATE_RetVal(FNeatAssetFilterQueryParams, FNeatAssetFilterPreviewGetParams);
+
+// Widget that displays how many assets a filter admits, and a few of them. The filter is polled, and a new query is
+// started once it has stopped changing for a moment.
+class SNeatAssetFilterPreview : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SNeatAssetFilterPreview) : _NumSamples(8) {}
+	SLATE_ARGUMENT(int32, NumSamples)
+	SLATE_EVENT(FNeatAssetFilterPreviewGetParams, GetParams)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+	virtual ~SNeatAssetFilterPreview() override;
+
+	virtual void Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime) override;
+
+protected:
+	void LaunchQuery();
+	void OnQueryDone();
+	FText GetSummaryText() const;
+
+private:
+	FNeatAssetFilterPreviewGetParams GetParams;
+	int32 NumSamples = 0;
+
+	TSharedPtr<SVerticalBox> SamplesBox;
+
+	// The filter of the latest query, or of the query that is waiting for edits to settle.
+	FNeatAssetFilterQueryParams Params;
+	bool bHasParams = false;
+	double LaunchTime = 0.0;
+
+	TSharedPtr<FNeatAssetFilterQuery, ESPMode::ThreadSafe> Query;
+	TOptional<FNeatAssetFilterQuery::FResult> Result;
+};
@@ -0,0 +1,224 @@
+﻿// Copyright Viktor Pramberg. All Rights Reserved.
+#pragma once
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/DeclarativeSyntaxSupport.h"
+#include "Widgets/Input/SComboButton.h"
+#include "Widgets/Input/SSearchBox.h"
+#include "Widgets/Layout/SBox.h"
+#include "Widgets/SBoxPanel.h"
+#include "Widgets/Views/SListView.h"
+#include "Widgets/Views/STableRow.h"
+#include "SListViewSelectorDropdownMenu.h"
+#include "NeatSearchIndex.h"
+
+// Combo button with a searchable list of items from a catalog, shared by the selectors that pick from one.
+// The owner fills the items and the search index, and decides what each row looks like and what picking an item does.
+template<typename ItemType>
+class SNeatCatalogSelector : public SCompoundWidget
+{
+public:
+	using FItemPtr = TSharedPtr<ItemType>;
+
+	// Fills the items and adds one search index entry per item, in the same order.
+	using FOnRefreshItems = TDelegate<void(TArray<FItemPtr>&, FNeatSearchIndex&)>;
+	// Adjusts the items shown for the trimmed search text. Also called when there is no search text.
+	using FOnFilterItems = TDelegate<void(const FString&, TArray<FItemPtr>&)>;
+	// Creates the content of a row. The attribute is the search text, for highlighting.
+	using FOnGenerateItem = TDelegate<TSharedRef<SWidget>(FItemPtr, const TAttribute<FText>&)>;
+	using FOnItemPicked = TDelegate<void(FItemPtr)>;
+
+	SLATE_BEGIN_ARGS(SNeatCatalogSelector)
+		: _HintText(INVTEXT("Search"))
+		, _MenuWidth(280.0f)
+		, _Generation(0)
+	{}
+	SLATE_NAMED_SLOT(FArguments, ButtonContent)
+	// Optional widget shown between the search box and the list.
+	SLATE_NAMED_SLOT(FArguments, MenuHeader)
+	SLATE_ARGUMENT(FText, HintText)
+	SLATE_ARGUMENT(float, MenuWidth)
+	// Items are rebuilt only when this has changed since the last time the menu was opened.
+	SLATE_ATTRIBUTE(uint32, Generation)
+	SLATE_EVENT(FOnRefreshItems, OnRefreshItems)
+	SLATE_EVENT(FOnFilterItems, OnFilterItems)
+	SLATE_EVENT(FOnGenerateItem, OnGenerateItem)
+	SLATE_EVENT(FOnItemPicked, OnItemPicked)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs)
+	{
+		HintText = InArgs._HintText;
+		MenuWidth = InArgs._MenuWidth;
+		MenuHeader = InArgs._MenuHeader.Widget;
+		Generation = InArgs._Generation;
+		OnRefreshItems = InArgs._OnRefreshItems;
+		OnFilterItems = InArgs._OnFilterItems;
+		OnGenerateItem = InArgs._OnGenerateItem;
+		OnItemPicked = InArgs._OnItemPicked;
+
+		ChildSlot
+		[
+			SAssignNew(ComboButton, SComboButton)
+			.OnGetMenuContent(this, &SNeatCatalogSelector::GetMenuContent)
+			.ButtonContent()
+			[
+				InArgs._ButtonContent.Widget
+			]
+		];
+	}
+
+	/** @brief Marks the items as outdated, so they are rebuilt the next time the menu is opened. */
+	void InvalidateItems()
+	{
+		bHasItems = false;
+	}
+
+protected:
+	TSharedRef<SWidget> GetMenuContent()
+	{
+		RefreshItems();
+
+		SearchText = FText();
+		RefreshFilteredItems();
+
+		TSharedPtr<SSearchBox> SearchBox;
+		SAssignNew(SearchBox, SSearchBox)
+		.HintText(HintText)
+		.OnTextChanged(this, &SNeatCatalogSelector::OnSearchTextChanged)
+		.OnTextCommitted(this, &SNeatCatalogSelector::OnSearchTextCommitted);
+
+		SAssignNew(ListView, SListView<FItemPtr>)
+		.ListItemsSource(&FilteredItems)
+		.SelectionMode(ESelectionMode::Single)
+		.OnSelectionChanged(this, &SNeatCatalogSelector::OnSelectionChanged)
+		.OnGenerateRow(this, &SNeatCatalogSelector::OnGenerateRow);
+
+		ComboButton->SetMenuContentWidgetToFocus(SearchBox);
+
+		return SNew(SListViewSelectorDropdownMenu<FItemPtr>, SearchBox, ListView)
+			[
+				SNew(SBox)
+				.WidthOverride(MenuWidth)
+				[
+					SNew(SVerticalBox)
+					+SVerticalBox::Slot()
+					.AutoHeight()
+					.Padding(4.0f)
+					[
+						SearchBox.ToSharedRef()
+					]
+					+SVerticalBox::Slot()
+					.AutoHeight()
+					[
+						MenuHeader.ToSharedRef()
+					]
+					+SVerticalBox::Slot()
+					.AutoHeight()
+					.MaxHeight(500)
+					.Padding(4.0f)
+					[
+						ListView.ToSharedRef()
+					]
+				]
+			];
+	}
+
+	void RefreshItems()
+	{
+		const uint32 CurrentGeneration = Generation.Get();
+		if (bHasItems && ItemsGeneration == CurrentGeneration)
+		{
+			return;
+		}
+
+		bHasItems = true;
+		ItemsGeneration = CurrentGeneration;
+		Items.Reset();
+		SearchIndex.Reset();
+		OnRefreshItems.ExecuteIfBound(Items, SearchIndex);
+	}
+
+	void RefreshFilteredItems()
+	{
+		FilteredItems.Reset();
+
+		const FString Search = SearchText.ToString().TrimStartAndEnd();
+		if (Search.IsEmpty())
+		{
+			FilteredItems = Items;
+		}
+		else
+		{
+			SearchIndex.Search(Search, SearchResults);
+			for (const FNeatSearchIndex::FResult& Result : SearchResults)
+			{
+				FilteredItems.Add(Items[Result.Id]);
+			}
+		}
+
+		OnFilterItems.ExecuteIfBound(Search, FilteredItems);
+	}
+
+	void OnSearchTextChanged(const FText& InText)
+	{
+		SearchText = InText;
+		RefreshFilteredItems();
+		ListView->RequestListRefresh();
+	}
+
+	void OnSearchTextCommitted(const FText& InText, ETextCommit::Type InCommitType)
+	{
+		if (InCommitType == ETextCommit::OnEnter && FilteredItems.Num() > 0)
+		{
+			ListView->SetSelection(FilteredItems[0], ESelectInfo::OnKeyPress);
+		}
+	}
+
+	void OnSelectionChanged(FItemPtr InItem, ESelectInfo::Type InSelectInfo)
+	{
+		// Selection also changes while navigating with the arrow keys, only pick the item once the selection is confirmed.
+		if (!InItem.IsValid() || InSelectInfo == ESelectInfo::OnNavigation)
+		{
+			return;
+		}
+
+		OnItemPicked.ExecuteIfBound(InItem);
+		ComboButton->SetIsOpen(false);
+	}
+
+	TSharedRef<ITableRow> OnGenerateRow(FItemPtr InItem, const TSharedRef<STableViewBase>& InParent)
+	{
+		return SNew(STableRow<FItemPtr>, InParent)
+		[
+			OnGenerateItem.IsBound() ? OnGenerateItem.Execute(InItem, TAttribute<FText>::CreateSP(this, &SNeatCatalogSelector::GetSearchText)) : SNullWidget::NullWidget
+		];
+	}
+
+	FText GetSearchText() const
+	{
+		return SearchText;
+	}
+
+private:
+	FText HintText;
+	float MenuWidth = 280.0f;
+	TSharedPtr<SWidget> MenuHeader;
+	TAttribute<uint32> Generation;
+	FOnRefreshItems OnRefreshItems;
+	FOnFilterItems OnFilterItems;
+	FOnGenerateItem OnGenerateItem;
+	FOnItemPicked OnItemPicked;
+
+	TSharedPtr<SComboButton> ComboButton;
+	TSharedPtr<SListView<FItemPtr>> ListView;
+
+	TArray<FItemPtr> Items;
+	TArray<FItemPtr> FilteredItems;
+	uint32 ItemsGeneration = 0;
+	bool bHasItems = false;
+
+	// Ids are indices into Items.
+	FNeatSearchIndex SearchIndex;
+	TArray<FNeatSearchIndex::FResult> SearchResults;
+	FText SearchText;
+};
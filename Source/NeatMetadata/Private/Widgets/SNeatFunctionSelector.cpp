@@ -1,5 +1,6 @@
 ﻿// Copyright Viktor Pramberg. All Rights Reserved.
 #include "SNeatFunctionSelector.h"
+#include "NeatFunctionIndex.h"
 #include "Widgets/Input/SSearchBox.h"
 #include "SListViewSelectorDropdownMenu.h"
 #include "Styling/SlateIconFinder.h"
@@ -13,20 +14,12 @@ enum class ENeatFunctionSelectorItemType : uint8
 	AddNewFunction,
 };
 
+// Items only reference their class or function by index, names and tooltips are resolved when a row is generated.
 struct FNeatFunctionSelectorItem
 {
-	explicit FNeatFunctionSelectorItem(const UClass* InClass) :
-		Object(InClass),
-		ItemType(ENeatFunctionSelectorItemType::Class),
-		ToolTip(InClass ? InClass->GetToolTipText() : FText())
-	{}
-	
-	explicit FNeatFunctionSelectorItem(const UFunction* InFunction, const bool bIsMemberFunction) :
-		Object(InFunction),
-		ItemType(bIsMemberFunction ? ENeatFunctionSelectorItemType::MemberFunction : ENeatFunctionSelectorItemType::StaticFunction),
-		ToolTip(InFunction ? InFunction->GetToolTipText() : FText()),
-		Value(bIsMemberFunction ? InFunction->GetName() : InFunction->GetPathName()),
-		Icon(FAppStyle::GetBrush(TEXT("Kismet.AllClasses.FunctionIcon")))
+	explicit FNeatFunctionSelectorItem(ENeatFunctionSelectorItemType InItemType, int32 InIndex) :
+		ItemType(InItemType),
+		Index(InIndex)
 	{}
 
 	explicit FNeatFunctionSelectorItem(const FText InText, const FText InToolTip = FText(), ENeatFunctionSelectorItemType InItemType = ENeatFunctionSelectorItemType::None) :
@@ -36,24 +29,25 @@ struct FNeatFunctionSelectorItem
 		Icon(FSlateIconFinder::FindIconBrushForClass(nullptr))
 	{}
 
-	void SetDisplayName(const FText& InText)
-	{
-		DisplayName = InText;
-	}
-
 	void SetIcon(const FSlateBrush* InIcon)
 	{
 		Icon = InIcon;
 	}
 
+	bool IsClass() const { return ItemType == ENeatFunctionSelectorItemType::Class; }
+	bool IsFunction() const { return ItemType == ENeatFunctionSelectorItemType::MemberFunction || ItemType == ENeatFunctionSelectorItemType::StaticFunction; }
+
 protected:
-	TWeakObjectPtr<const UStruct> Object = nullptr;
 	ENeatFunctionSelectorItemType ItemType = ENeatFunctionSelectorItemType::None;
+	// Index into SNeatFunctionSelector::Classes for classes, or SNeatFunctionSelector::Functions for functions.
+	int32 Index = INDEX_NONE;
+	// Only used by items that aren't classes or functions.
 	FText DisplayName;
 	FText ToolTip;
-	FString Value;
 	const FSlateBrush* Icon = nullptr;
+	// Children of class items, which are created when the class is expanded.
 	TArray<FNeatFunctionSelectorItemPtr> Children;
+	bool bChildrenCreated = false;
 
 	friend class SNeatFunctionSelector;
 };
@@ -107,11 +101,11 @@ TSharedRef<SWidget> SNeatFunctionSelector::OnGetMenuContent()
 	.SelectionMode(ESelectionMode::Single)
 	.ItemHeight(32)
 	.OnSelectionChanged(this, &SNeatFunctionSelector::OnSelectionChanged)
-	.OnGetChildren_Lambda([this](FNeatFunctionSelectorItemPtr InParent, TArray<FNeatFunctionSelectorItemPtr>& OutChildren) { OutChildren = InParent->Children; })
+	.OnGetChildren(this, &SNeatFunctionSelector::OnGetChildren)
 	.OnGenerateRow(this, &SNeatFunctionSelector::OnGenerateRow);
 
 	ComboButton->SetMenuContentWidgetToFocus(SearchBox);
-	if (!FilteredItems.IsEmpty())
+	if (FilteredItems.IsValidIndex(1))
 	{
 		TreeView->SetItemExpansion(FilteredItems[1], true);
 	}
@@ -139,14 +133,52 @@ TSharedRef<SWidget> SNeatFunctionSelector::OnGetMenuContent()
 		];
 }
 
+void SNeatFunctionSelector::OnGetChildren(FNeatFunctionSelectorItemPtr InParent, TArray<FNeatFunctionSelectorItemPtr>& OutChildren)
+{
+	if (!InParent->IsClass())
+	{
+		return;
+	}
+
+	if (!InParent->bChildrenCreated)
+	{
+		// The tree asks collapsed items for children too, to know whether to show an expander arrow.
+		if (!TreeView->IsItemExpanded(InParent))
+		{
+			OutChildren.Add(PlaceholderItem);
+			return;
+		}
+
+		const FClassEntry& ClassEntry = Classes[InParent->Index];
+		InParent->Children.Reserve(ClassEntry.NumFunctions + 1);
+		for (int32 Idx = ClassEntry.FirstFunction; Idx < ClassEntry.FirstFunction + ClassEntry.NumFunctions; Idx++)
+		{
+			InParent->Children.Add(GetFunctionItem(Idx));
+		}
+
+		if (ClassEntry.bIsOwnerClass)
+		{
+			static const FText AddFunctionName(INVTEXT("Add new function..."));
+			static const FText AddFunctionTooltip(INVTEXT("Adds a new function with the correct signature to be used with this property."));
+			const auto Item = MakeShared<FNeatFunctionSelectorItem>(AddFunctionName, AddFunctionTooltip, ENeatFunctionSelectorItemType::AddNewFunction);
+			Item->SetIcon(FAppStyle::GetBrush(TEXT("Icons.PlusCircle")));
+			InParent->Children.Add(Item);
+		}
+		
+		InParent->bChildrenCreated = true;
+	}
+
+	OutChildren = InParent->Children;
+}
+
 void SNeatFunctionSelector::OnSelectionChanged(FNeatFunctionSelectorItemPtr InSelection, ESelectInfo::Type InSelectInfo) const
 {
-	if (!InSelection.IsValid())
+	if (!InSelection.IsValid() || InSelection == PlaceholderItem)
 	{
 		return;
 	}
 		
-	if (InSelection->Children.Num())
+	if (InSelection->IsClass())
 	{
 		const bool bIsExpanded = TreeView->IsItemExpanded(InSelection);
 		TreeView->SetItemExpansion(InSelection, !bIsExpanded);
@@ -172,31 +204,42 @@ void SNeatFunctionSelector::OnSearchTextChanged(const FText& ChangedText)
 	{
 		FilteredItems.Append(Items);
 		
-		if (!FilteredItems.IsEmpty())
+		if (FilteredItems.IsValidIndex(1))
 		{
 			TreeView->SetItemExpansion(FilteredItems[1], true);
 		}
 	}
 	else
 	{
-		for (const FNeatFunctionSelectorItemPtr& Item : Items)
+		BuildSearchIndex();
+		
+		for (const FNeatFunctionSelectorItemPtr& FilteredParent : FilteredParents)
 		{
-			FNeatFunctionSelectorItemPtr FilteredItem = nullptr;
-			for (const FNeatFunctionSelectorItemPtr& Child : Item->Children)
+			if (FilteredParent)
 			{
-				if (Child->Object.IsValid() && Child->Object->GetName().Contains(SearchText.ToString()))
-				{
-					if (!FilteredItem)
-					{
-						FilteredItem = MakeShared<FNeatFunctionSelectorItem>(*Item);
-						FilteredItem->Children.Reset();
-						FilteredItems.Add(FilteredItem);
-						TreeView->SetItemExpansion(FilteredItem, true);
-					}
-					FilteredItem->Children.Add(Child);
-				}
+				FilteredParent->Children.Reset();
 			}
 		}
+
+		// Results are ranked, so classes end up ordered by their best match, and functions by how well they match.
+		SearchIndex.Search(SearchText.ToString(), SearchResults);
+		for (const FNeatSearchIndex::FResult& Result : SearchResults)
+		{
+			const int32 ClassIndex = Functions[Result.Id].ClassIndex;
+			FNeatFunctionSelectorItemPtr& FilteredParent = FilteredParents[ClassIndex];
+			if (!FilteredParent)
+			{
+				FilteredParent = MakeShared<FNeatFunctionSelectorItem>(ENeatFunctionSelectorItemType::Class, ClassIndex);
+				FilteredParent->bChildrenCreated = true;
+			}
+			
+			if (FilteredParent->Children.IsEmpty())
+			{
+				FilteredItems.Add(FilteredParent);
+				TreeView->SetItemExpansion(FilteredParent, true);
+			}
+			FilteredParent->Children.Add(GetFunctionItem(Result.Id));
+		}
 	}
 
 	TreeView->RequestTreeRefresh();
@@ -206,8 +249,10 @@ void SNeatFunctionSelector::OnSearchTextCommitted(const FText& InText, ETextComm
 {
 	if ((InCommitType == ETextCommit::Type::OnEnter) && FilteredItems.Num() > 0)
 	{
-		TreeView->SetSelection(FilteredItems[0], ESelectInfo::OnKeyPress);
-		SetCurrentItem(FilteredItems[0]);
+		// While searching, the first item is the class of the best match.
+		const FNeatFunctionSelectorItemPtr& BestItem = FilteredItems[0]->Children.IsEmpty() || SearchText.IsEmpty() ? FilteredItems[0] : FilteredItems[0]->Children[0];
+		TreeView->SetSelection(BestItem, ESelectInfo::OnKeyPress);
+		SetCurrentItem(BestItem);
 	}
 }
 
@@ -222,25 +267,38 @@ void SNeatFunctionSelector::SetCurrentItem(FNeatFunctionSelectorItemPtr InItem)
 		
 		return;
 	}
+
+	FString Value;
+	if (InItem->IsFunction())
+	{
+		const FFunctionEntry& Entry = Functions[InItem->Index];
+		if (const UFunction* Function = Entry.Function.Get())
+		{
+			Value = Entry.bIsMemberFunction ? Function->GetName() : Function->GetPathName();
+		}
+	}
 	
-	PropertyHandle->SetValue(InItem->Value);
+	PropertyHandle->SetValue(Value);
 
 	ComboButton->SetIsOpen(false);
 }
 
 TSharedRef<ITableRow> SNeatFunctionSelector::OnGenerateRow(FNeatFunctionSelectorItemPtr InItem, const TSharedRef<STableViewBase>& InParent) const
 {
+	const bool bIsClass = InItem->IsClass();
+	const FSlateBrush* Icon = InItem->IsFunction() ? FAppStyle::GetBrush(TEXT("Kismet.AllClasses.FunctionIcon")) : InItem->Icon;
+	
 	return SNew(STableRow<TSharedPtr<FText>>, InParent)
 	[
 		SNew(SHorizontalBox)
-		.ToolTipText(InItem->ToolTip)
+		.ToolTipText(GetItemToolTip(*InItem))
 		+SHorizontalBox::Slot()
 		.AutoWidth()
 		.Padding(0.0f, 3.0f, 6.0f, 3.0f)
 		[
 			SNew(SImage)
-			.Image(InItem->Icon)
-			.Visibility(InItem->Children.IsEmpty() ? EVisibility::Visible : EVisibility::Collapsed)
+			.Image(Icon)
+			.Visibility(bIsClass ? EVisibility::Collapsed : EVisibility::Visible)
 		]
 		+SHorizontalBox::Slot()
 		.FillWidth(1.0f)
@@ -248,9 +306,9 @@ TSharedRef<ITableRow> SNeatFunctionSelector::OnGenerateRow(FNeatFunctionSelector
 		.Padding(0.0f, 3.0f, 6.0f, 3.0f)
 		[
 			SNew(STextBlock)
-			.Text(InItem->DisplayName.IsEmpty() && InItem->Object.IsValid() ? InItem->Object->GetDisplayNameText() : InItem->DisplayName)
+			.Text(GetItemDisplayName(*InItem))
 			.HighlightText_Lambda([this]() { return SearchText; })
-			.Font(InItem->Children.IsEmpty() ? FAppStyle::GetFontStyle(TEXT("NormalFont")) : FAppStyle::GetFontStyle(TEXT("NormalFontItalic")))
+			.Font(bIsClass ? FAppStyle::GetFontStyle(TEXT("NormalFontItalic")) : FAppStyle::GetFontStyle(TEXT("NormalFont")))
 		]
  			
 	];
@@ -259,63 +317,146 @@ TSharedRef<ITableRow> SNeatFunctionSelector::OnGenerateRow(FNeatFunctionSelector
 void SNeatFunctionSelector::RefreshFunctions()
 {
 	Items.Reset();
+	Classes.Reset();
+	Functions.Reset();
+	FunctionItems.Reset();
+	FilteredParents.Reset();
+	SearchIndex.Reset();
+	bSearchIndexBuilt = false;
 
 	{
 		Items.Add(MakeShared<FNeatFunctionSelectorItem>(INVTEXT("None")));
 	}
 
-	const UClass* OwnerClass = MemberClass.Get(nullptr);
-	FNeatFunctionSelectorItemPtr OwnerItem;
-	if (OwnerClass)
+	if (!PlaceholderItem)
 	{
-		OwnerItem = MakeShared<FNeatFunctionSelectorItem>(OwnerClass);
-		OwnerItem->SetDisplayName(FText::Format(INVTEXT("{0} (Self)"), OwnerClass->GetDisplayNameText()));
-		Items.Add(OwnerItem);
+		PlaceholderItem = MakeShared<FNeatFunctionSelectorItem>(FText::GetEmpty());
 	}
 
-	auto IsMemberFunction = [OwnerClass](const UFunction* Function)
+	auto AddClass = [this](const UClass* InClass)
+	{
+		const int32 ClassIndex = Classes.AddDefaulted();
+		Classes[ClassIndex].Class = InClass;
+		Classes[ClassIndex].FirstFunction = Functions.Num();
+		Items.Add(MakeShared<FNeatFunctionSelectorItem>(ENeatFunctionSelectorItemType::Class, ClassIndex));
+		return ClassIndex;
+	};
+
+	auto AddFunction = [this](const UFunction* InFunction, int32 InClassIndex, bool bIsMemberFunction)
+	{
+		Functions.Add({ InFunction, InClassIndex, bIsMemberFunction });
+		Classes[InClassIndex].NumFunctions++;
+	};
+
+	// Member functions are looked up directly, since they may still be on a skeleton class that isn't part of the index.
+	const UClass* OwnerClass = MemberClass.Get(nullptr);
+	if (OwnerClass)
 	{
-		for (const UClass* Class = OwnerClass; Class; Class = Class->GetSuperClass())
+		const int32 OwnerIndex = AddClass(OwnerClass);
+		Classes[OwnerIndex].DisplayNameOverride = FText::Format(INVTEXT("{0} (Self)"), OwnerClass->GetDisplayNameText());
+		Classes[OwnerIndex].bIsOwnerClass = true;
+		
+		for (const UFunction* Function : TFieldRange<UFunction>(OwnerClass, EFieldIteratorFlags::IncludeSuper))
 		{
-			if (Function->IsIn(Class))
+			if (Function->HasAnyFunctionFlags(FUNC_BlueprintCallable | FUNC_BlueprintPure) && FunctionFilter.Execute(Function, true))
 			{
-				return true;
+				AddFunction(Function, OwnerIndex, true);
 			}
 		}
-		return false;
-	};
-		
-	for (const UFunction* Function : TObjectRange<UFunction>())
+	}
+
+	// The index visits functions grouped by the class that declares them, so each class becomes one contiguous range.
+	const UClass* CurrentClass = nullptr;
+	int32 CurrentClassIndex = INDEX_NONE;
+	FNeatFunctionIndex::Get().ForEachFunction([&](const UClass& Class, const UFunction& Function)
 	{
-		const bool bIsMemberFunction = IsMemberFunction(Function);
-		if (!Function->HasAnyFunctionFlags(FUNC_BlueprintCallable | FUNC_BlueprintPure) || !FunctionFilter.Execute(Function, bIsMemberFunction))
+		if (OwnerClass && OwnerClass->IsChildOf(&Class))
 		{
-			continue;
+			return;
 		}
 
-		auto Item = MakeShared<FNeatFunctionSelectorItem>(Function, bIsMemberFunction);
-		if (bIsMemberFunction && OwnerItem)
+		if (&Class != CurrentClass)
 		{
-			OwnerItem->Children.Add(Item);
+			CurrentClass = &Class;
+			CurrentClassIndex = INDEX_NONE;
 		}
-		else
+
+		if (!FunctionFilter.Execute(&Function, false))
 		{
-			const FNeatFunctionSelectorItemPtr* FoundOuter = Items.FindByPredicate([Function](const FNeatFunctionSelectorItemPtr& Item) { return Item->Object == Function->GetOuterUClass(); });
-			if (!FoundOuter)
-			{
-				FoundOuter = &Items.Add_GetRef(MakeShared<FNeatFunctionSelectorItem>(Function->GetOuterUClass()));
-			}
+			return;
+		}
 
-			FoundOuter->Get()->Children.Add(Item);
+		if (CurrentClassIndex == INDEX_NONE)
+		{
+			CurrentClassIndex = AddClass(&Class);
 		}
+		AddFunction(&Function, CurrentClassIndex, false);
+	});
+
+	FunctionItems.SetNum(Functions.Num());
+	FilteredParents.SetNum(Classes.Num());
+}
+
+void SNeatFunctionSelector::BuildSearchIndex()
+{
+	if (bSearchIndexBuilt)
+	{
+		return;
 	}
 
-	if (OwnerItem)
+	bSearchIndexBuilt = true;
+	for (const FFunctionEntry& Entry : Functions)
 	{
-		static const FText AddFunctionName(INVTEXT("Add new function..."));
-		static const FText AddFunctionTooltip(INVTEXT("Adds a new function with the correct signature to be used with this property."));
-		const auto Item = MakeShared<FNeatFunctionSelectorItem>(AddFunctionName, AddFunctionTooltip, ENeatFunctionSelectorItemType::AddNewFunction);
-		Item->SetIcon(FAppStyle::GetBrush(TEXT("Icons.PlusCircle")));
-		OwnerItem->Children.Add(Item);
+		const UFunction* Function = Entry.Function.Get();
+		const int32 Id = Function
+			? SearchIndex.Add(Function->GetName(), Function->GetDisplayNameText().ToString(), Function->GetToolTipText().ToString())
+			: SearchIndex.Add(FString(), FString(), FString());
+		check(Id == SearchIndex.Num() - 1);
 	}
 }
+
+FNeatFunctionSelectorItemPtr SNeatFunctionSelector::GetFunctionItem(int32 InFunctionIndex)
+{
+	FNeatFunctionSelectorItemPtr& Item = FunctionItems[InFunctionIndex];
+	if (!Item)
+	{
+		const ENeatFunctionSelectorItemType ItemType = Functions[InFunctionIndex].bIsMemberFunction ? ENeatFunctionSelectorItemType::MemberFunction : ENeatFunctionSelectorItemType::StaticFunction;
+		Item = MakeShared<FNeatFunctionSelectorItem>(ItemType, InFunctionIndex);
+	}
+	return Item;
+}
+
+FText SNeatFunctionSelector::GetItemDisplayName(const FNeatFunctionSelectorItem& InItem) const
+{
+	if (InItem.IsClass())
+	{
+		const FClassEntry& Entry = Classes[InItem.Index];
+		const UClass* Class = Entry.Class.Get();
+		return !Entry.DisplayNameOverride.IsEmpty() || !Class ? Entry.DisplayNameOverride : Class->GetDisplayNameText();
+	}
+
+	if (InItem.IsFunction())
+	{
+		const UFunction* Function = Functions[InItem.Index].Function.Get();
+		return Function ? Function->GetDisplayNameText() : FText();
+	}
+
+	return InItem.DisplayName;
+}
+
+FText SNeatFunctionSelector::GetItemToolTip(const FNeatFunctionSelectorItem& InItem) const
+{
+	if (InItem.IsClass())
+	{
+		const UClass* Class = Classes[InItem.Index].Class.Get();
+		return Class ? Class->GetToolTipText() : FText();
+	}
+
+	if (InItem.IsFunction())
+	{
+		const UFunction* Function = Functions[InItem.Index].Function.Get();
+		return Function ? Function->GetToolTipText() : FText();
+	}
+
+	return InItem.ToolTip;
+}
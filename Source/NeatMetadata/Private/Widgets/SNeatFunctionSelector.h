@@ -1,6 +1,7 @@
 ﻿// Copyright Viktor Pramberg. All Rights Reserved.
 #pragma once
 #include "CoreMinimal.h"
+#include "NeatSearchIndex.h"
 
 // FNeatFunctionSelectorItem is in the cpp file.
 using FNeatFunctionSelectorItemPtr = TSharedPtr<struct FNeatFunctionSelectorItem>;
@@ -27,18 +28,54 @@ public:
 protected:
 	FText GetText() const;
 	TSharedRef<SWidget> OnGetMenuContent();
+	void OnGetChildren(FNeatFunctionSelectorItemPtr InParent, TArray<FNeatFunctionSelectorItemPtr>& OutChildren);
 	void OnSelectionChanged(FNeatFunctionSelectorItemPtr InSelection, ESelectInfo::Type InSelectInfo) const;
 	void OnSearchTextChanged(const FText& ChangedText);
 	void OnSearchTextCommitted(const FText& InText, ETextCommit::Type InCommitType);
 	void SetCurrentItem(FNeatFunctionSelectorItemPtr InItem) const;
 	TSharedRef<class ITableRow> OnGenerateRow(FNeatFunctionSelectorItemPtr InItem, const TSharedRef< class STableViewBase >& InParent) const;
 	void RefreshFunctions();
+	void BuildSearchIndex();
+
+	FNeatFunctionSelectorItemPtr GetFunctionItem(int32 InFunctionIndex);
+	FText GetItemDisplayName(const FNeatFunctionSelectorItem& InItem) const;
+	FText GetItemToolTip(const FNeatFunctionSelectorItem& InItem) const;
 
 private:
+	struct FFunctionEntry
+	{
+		TWeakObjectPtr<const UFunction> Function;
+		int32 ClassIndex = INDEX_NONE;
+		bool bIsMemberFunction = false;
+	};
+
+	// A contiguous range of Functions that are declared in the same class.
+	struct FClassEntry
+	{
+		TWeakObjectPtr<const UClass> Class;
+		FText DisplayNameOverride;
+		int32 FirstFunction = 0;
+		int32 NumFunctions = 0;
+		bool bIsOwnerClass = false;
+	};
+
 	TSharedPtr<IPropertyHandle> PropertyHandle;
+
+	TArray<FClassEntry> Classes;
+	TArray<FFunctionEntry> Functions;
+	// Items for Functions, which are only created once they are shown.
+	TArray<FNeatFunctionSelectorItemPtr> FunctionItems;
 	
 	TArray<FNeatFunctionSelectorItemPtr> Items;
 	TArray<FNeatFunctionSelectorItemPtr> FilteredItems;
+	FNeatFunctionSelectorItemPtr PlaceholderItem;
+
+	// The search index is built the first time something is searched for. Ids are indices into Functions.
+	FNeatSearchIndex SearchIndex;
+	bool bSearchIndexBuilt = false;
+	// A copy of each class item, that holds the children that match the current search. Indexed like Classes.
+	TArray<FNeatFunctionSelectorItemPtr> FilteredParents;
+	TArray<FNeatSearchIndex::FResult> SearchResults;
 	
 	FText SearchText;
 	TSharedPtr<SNeatFunctionSelectorTreeView> TreeView;
@@ -2,28 +2,17 @@
 
 
 #include "SNeatInterfaceSelector.h"
+#include "NeatInterfaceCatalog.h"
 
-#include "ClassViewerFilter.h"
-#include "ClassViewerModule.h"
 #include "DetailLayoutBuilder.h"
+#include "Styling/SlateIconFinder.h"
 
-namespace
+struct FNeatInterfaceSelectorItem
 {
-	// Class filter that only shows interfaces.
-	class FNeatInterfaceClassFilter : public IClassViewerFilter
-	{
-	public:
-		virtual bool IsClassAllowed(const FClassViewerInitializationOptions& InInitOptions, const UClass* InClass, TSharedRef<FClassViewerFilterFuncs> InFilterFuncs) override
-		{
-			return InClass->HasAnyClassFlags(EClassFlags::CLASS_Interface);
-		}
-
-		virtual bool IsUnloadedClassAllowed(const FClassViewerInitializationOptions& InInitOptions, const TSharedRef<const IUnloadedBlueprintData> InClass, TSharedRef<FClassViewerFilterFuncs> InFilterFuncs) override
-		{
-			return InClass->HasAnyClassFlags(EClassFlags::CLASS_Interface);
-		}
-	};
-}
+	// Null for the "None" item.
+	FTopLevelAssetPath ClassPath;
+	FText DisplayName;
+};
 
 void SNeatInterfaceSelector::Construct(const FArguments&, TSharedRef<IPropertyHandle> InPropertyHandle)
 {
@@ -31,8 +20,11 @@ void SNeatInterfaceSelector::Construct(const FArguments&, TSharedRef<IPropertyHa
 
 	ChildSlot
 	[
-		SAssignNew(ComboButton, SComboButton)
-		.OnGetMenuContent(this, &SNeatInterfaceSelector::GetMenuContent)
+		SNew(SNeatCatalogSelector<FNeatInterfaceSelectorItem>)
+		.Generation_Lambda([]() { return FNeatInterfaceCatalog::Get().GetGeneration(); })
+		.OnRefreshItems(this, &SNeatInterfaceSelector::OnRefreshItems)
+		.OnGenerateItem(this, &SNeatInterfaceSelector::OnGenerateItem)
+		.OnItemPicked(this, &SNeatInterfaceSelector::OnItemPicked)
 		.ButtonContent()
 		[
 			SNew(STextBlock)
@@ -42,38 +34,57 @@ void SNeatInterfaceSelector::Construct(const FArguments&, TSharedRef<IPropertyHa
 	];
 }
 
-TSharedRef<SWidget> SNeatInterfaceSelector::GetMenuContent()
+void SNeatInterfaceSelector::OnRefreshItems(TArray<FNeatInterfaceSelectorItemPtr>& OutItems, FNeatSearchIndex& OutSearchIndex) const
 {
-	FClassViewerModule& ClassViewerModule = FModuleManager::LoadModuleChecked<FClassViewerModule>("ClassViewer");
-	FClassViewerInitializationOptions Options;
-	Options.bShowUnloadedBlueprints = true;
-	Options.bShowNoneOption = true;
-	Options.bAllowViewOptions = false;
-	Options.NameTypeToDisplay = EClassViewerNameTypeToDisplay::DisplayName;
-	Options.PropertyHandle = PropertyHandle;
-	Options.ClassFilters.Add(MakeShared<FNeatInterfaceClassFilter>());
+	FNeatInterfaceCatalog::Get().ForEachEntry([&OutItems](const FNeatInterfaceCatalog::FEntry& Entry)
+	{
+		OutItems.Add(MakeShared<FNeatInterfaceSelectorItem>(FNeatInterfaceSelectorItem{ Entry.ClassPath, Entry.DisplayName }));
+	});
 
-	return SNew(SBox)
-		.WidthOverride(280)
+	OutItems.Sort([](const FNeatInterfaceSelectorItemPtr& A, const FNeatInterfaceSelectorItemPtr& B)
+	{
+		return A->DisplayName.CompareTo(B->DisplayName) < 0;
+	});
+	OutItems.Insert(MakeShared<FNeatInterfaceSelectorItem>(FNeatInterfaceSelectorItem{ FTopLevelAssetPath(), INVTEXT("None") }), 0);
+
+	for (const FNeatInterfaceSelectorItemPtr& Item : OutItems)
+	{
+		OutSearchIndex.Add(Item->ClassPath.GetAssetName().ToString(), Item->DisplayName.ToString(), FString());
+	}
+}
+
+TSharedRef<SWidget> SNeatInterfaceSelector::OnGenerateItem(FNeatInterfaceSelectorItemPtr InItem, const TAttribute<FText>& InHighlightText) const
+{
+	return SNew(SHorizontalBox)
+		.ToolTipText(InItem->ClassPath.IsNull() ? FText() : FText::FromString(InItem->ClassPath.ToString()))
+		+SHorizontalBox::Slot()
+		.AutoWidth()
+		.Padding(0.0f, 3.0f, 6.0f, 3.0f)
 		[
-			SNew(SVerticalBox)
-			+SVerticalBox::Slot()
-			.AutoHeight()
-			.MaxHeight(500)
-			[
-				ClassViewerModule.CreateClassViewer(Options, FOnClassPicked::CreateSP(this, &SNeatInterfaceSelector::OnClassPicked))
-			]
+			SNew(SImage)
+			.Image(FSlateIconFinder::FindIconBrushForClass(UInterface::StaticClass()))
+			.Visibility(InItem->ClassPath.IsNull() ? EVisibility::Hidden : EVisibility::Visible)
+		]
+		+SHorizontalBox::Slot()
+		.FillWidth(1.0f)
+		.VAlign(VAlign_Center)
+		.Padding(0.0f, 3.0f, 6.0f, 3.0f)
+		[
+			SNew(STextBlock)
+			.Text(InItem->DisplayName)
+			.HighlightText(InHighlightText)
+			.Font(IDetailLayoutBuilder::GetDetailFont())
 		];
 }
 
-void SNeatInterfaceSelector::OnClassPicked(UClass* InClass) const
+void SNeatInterfaceSelector::OnItemPicked(FNeatInterfaceSelectorItemPtr InItem) const
 {
-	if (GetClass() != InClass)
+	// Unloaded Blueprint interfaces are only loaded once they are picked.
+	UClass* Class = FNeatInterfaceCatalog::LoadInterfaceClass(InItem->ClassPath);
+	if (GetClass() != Class)
 	{
-		PropertyHandle->SetValue(InClass);
+		PropertyHandle->SetValue(Class);
 	}
-	
-	ComboButton->SetIsOpen(false);
 }
 
 UClass* SNeatInterfaceSelector::GetClass() const
@@ -4,9 +4,12 @@
 #include "Widgets/DeclarativeSyntaxSupport.h"
 #include "UObject/Class.h"
 #include "Internationalization/Text.h"
+#include "SNeatCatalogSelector.h"
 
 class IPropertyHandle;
-class SComboButton;
+
+// FNeatInterfaceSelectorItem is in the cpp file.
+using FNeatInterfaceSelectorItemPtr = TSharedPtr<struct FNeatInterfaceSelectorItem>;
 
 // Widget that displays all available interfaces.
 class SNeatInterfaceSelector : public SCompoundWidget
@@ -17,12 +20,12 @@ class SNeatInterfaceSelector : public SCompoundWidget
 	void Construct(const FArguments&, TSharedRef<IPropertyHandle> InPropertyHandle);
 
 protected:
-	TSharedRef<SWidget> GetMenuContent();
-	void OnClassPicked(UClass* InClass) const;
+	void OnRefreshItems(TArray<FNeatInterfaceSelectorItemPtr>& OutItems, FNeatSearchIndex& OutSearchIndex) const;
+	TSharedRef<SWidget> OnGenerateItem(FNeatInterfaceSelectorItemPtr InItem, const TAttribute<FText>& InHighlightText) const;
+	void OnItemPicked(FNeatInterfaceSelectorItemPtr InItem) const;
 	UClass* GetClass() const;
 	FText GetButtonText() const;
 
 private:
 	TSharedPtr<IPropertyHandle> PropertyHandle;
-	TSharedPtr<SComboButton> ComboButton;
-};
\ No newline at end of file
+};
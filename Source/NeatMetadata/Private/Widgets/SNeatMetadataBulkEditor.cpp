@@ -0,0 +1,625 @@
+﻿// Copyright Viktor Pramberg. All Rights Reserved.
+#include "SNeatMetadataBulkEditor.h"
+#include "NeatMetadataAssetTags.h"
+#include "NeatMetadataBatch.h"
+#include "NeatMetadataCollection.h"
+#include "NeatMetadataCollectionLayout.h"
+#include "NeatMetadataCollectionRegistry.h"
+#include "NeatMetadataModule.h"
+#include "NeatMetadataWrapper.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Algo/AnyOf.h"
+#include "Engine/Blueprint.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Framework/Docking/TabManager.h"
+#include "Framework/MultiBox/MultiBoxBuilder.h"
+#include "ScopedTransaction.h"
+#include "Styling/StyleColors.h"
+#include "UObject/StrongObjectPtr.h"
+#include "Widgets/Docking/SDockTab.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/Input/SCheckBox.h"
+#include "Widgets/Input/SComboBox.h"
+#include "Widgets/Input/SEditableTextBox.h"
+#include "Widgets/Input/SSearchBox.h"
+#include "Widgets/Layout/SBox.h"
+#include "Widgets/Text/SInlineEditableTextBlock.h"
+#include "Widgets/Views/SHeaderRow.h"
+#include "WorkspaceMenuStructure.h"
+#include "WorkspaceMenuStructureModule.h"
+
+struct FNeatMetadataBulkEditorRow
+{
+	FSoftObjectPath Blueprint;
+	FString BlueprintName;
+	FNeatMetadataVariableSummary Variable;
+	// Values that haven't been applied yet, by collection property name.
+	TMap<FName, FString> PendingValues;
+};
+
+namespace
+{
+	const FName BlueprintColumn("Blueprint");
+	const FName VariableColumn("Variable");
+	const FName TypeColumn("Type");
+
+	// The text of the default value of a collection property. Used when a cell is cleared.
+	FString GetDefaultValue(UClass& InClass, FName InPropertyName)
+	{
+		FString Result;
+		if (const FProperty* Property = FindFProperty<FProperty>(&InClass, InPropertyName))
+		{
+			Property->ExportText_InContainer(0, Result, InClass.GetDefaultObject(), nullptr, nullptr, PPF_None);
+		}
+		return Result;
+	}
+}
+
+// Cells are only evaluated while they are visible, and refer to the row data instead of copying it, so that scrolling
+// through many rows is cheap.
+class SNeatMetadataBulkEditorTableRow : public SMultiColumnTableRow<FNeatMetadataBulkEditorRowPtr>
+{
+public:
+	SLATE_BEGIN_ARGS(SNeatMetadataBulkEditorTableRow) {}
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments&, const TSharedRef<STableViewBase>& InOwnerTable, FNeatMetadataBulkEditorRowPtr InRow, SNeatMetadataBulkEditor* InEditor)
+	{
+		Row = InRow;
+		Editor = InEditor;
+		FSuperRowType::Construct(FSuperRowType::FArguments(), InOwnerTable);
+	}
+
+	virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& InColumnName) override
+	{
+		if (InColumnName == BlueprintColumn)
+		{
+			return SNew(STextBlock)
+				.Text(FText::FromString(Row->BlueprintName))
+				.ToolTipText(FText::FromString(Row->Blueprint.ToString()));
+		}
+
+		if (InColumnName == VariableColumn)
+		{
+			return SNew(STextBlock)
+				.Text(FText::FromName(Row->Variable.Variable));
+		}
+
+		if (InColumnName == TypeColumn)
+		{
+			return SNew(STextBlock)
+				.Text(FText::FromString(Row->Variable.Type))
+				.ColorAndOpacity(FSlateColor::UseSubduedForeground());
+		}
+
+		return SNew(SInlineEditableTextBlock)
+			.Text(this, &SNeatMetadataBulkEditorTableRow::GetCellText, InColumnName)
+			.ColorAndOpacity(this, &SNeatMetadataBulkEditorTableRow::GetCellColor, InColumnName)
+			.IsSelected(this, &SNeatMetadataBulkEditorTableRow::IsSelectedExclusively)
+			.OnTextCommitted(this, &SNeatMetadataBulkEditorTableRow::OnCellCommitted, InColumnName);
+	}
+
+private:
+	FText GetCellText(FName InPropertyName) const
+	{
+		return FText::FromString(Editor->GetCellValue(*Row, InPropertyName));
+	}
+
+	FSlateColor GetCellColor(FName InPropertyName) const
+	{
+		return Editor->IsCellPending(*Row, InPropertyName) ? FSlateColor(EStyleColor::AccentYellow) : FSlateColor::UseForeground();
+	}
+
+	void OnCellCommitted(const FText& InText, ETextCommit::Type InCommitType, FName InPropertyName)
+	{
+		if (InCommitType != ETextCommit::OnCleared)
+		{
+			Editor->SetCellValue(Row, InPropertyName, InText.ToString());
+		}
+	}
+
+	FNeatMetadataBulkEditorRowPtr Row;
+	// The editor owns the list view, and with that all rows.
+	SNeatMetadataBulkEditor* Editor = nullptr;
+};
+
+const FName SNeatMetadataBulkEditor::TabName("NeatMetadataBulkEditor");
+
+void SNeatMetadataBulkEditor::RegisterTabSpawner()
+{
+	if (!FSlateApplication::IsInitialized())
+	{
+		return;
+	}
+
+	FGlobalTabmanager::Get()->RegisterNomadTabSpawner(TabName, FOnSpawnTab::CreateLambda([](const FSpawnTabArgs&)
+	{
+		return SNew(SDockTab)
+			.TabRole(ETabRole::NomadTab)
+			[
+				SNew(SNeatMetadataBulkEditor)
+			];
+	}))
+	.SetDisplayName(INVTEXT("Bulk Metadata Editor"))
+	.SetTooltipText(INVTEXT("Edit the metadata of many Blueprint variables at once."))
+	.SetGroup(WorkspaceMenu::GetMenuStructure().GetToolsCategory());
+}
+
+void SNeatMetadataBulkEditor::UnregisterTabSpawner()
+{
+	if (FSlateApplication::IsInitialized())
+	{
+		FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(TabName);
+	}
+}
+
+void SNeatMetadataBulkEditor::Construct(const FArguments& InArgs)
+{
+	FNeatMetadataCollectionRegistry::Get().ForEachClass([this](UClass& Class) { Collections.Add(&Class); });
+	Collections.Sort([](const TWeakObjectPtr<UClass>& A, const TWeakObjectPtr<UClass>& B)
+	{
+		return A->GetDisplayNameText().CompareTo(B->GetDisplayNameText()) < 0;
+	});
+	SelectedCollection = Collections.IsEmpty() ? TWeakObjectPtr<UClass>() : Collections[0];
+
+	ChildSlot
+	[
+		SNew(SVerticalBox)
+		+SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(4.0f)
+		[
+			SNew(SHorizontalBox)
+			+SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(0.0f, 0.0f, 4.0f, 0.0f)
+			[
+				SNew(SComboBox<TWeakObjectPtr<UClass>>)
+				.OptionsSource(&Collections)
+				.InitiallySelectedItem(SelectedCollection)
+				.OnGenerateWidget(this, &SNeatMetadataBulkEditor::OnGenerateCollectionWidget)
+				.OnSelectionChanged(this, &SNeatMetadataBulkEditor::OnCollectionChanged)
+				.IsEnabled_Lambda([this]() { return NumPendingValues == 0; })
+				.ToolTipText(INVTEXT("The collection whose properties are shown as columns. Apply or discard changes to switch collection."))
+				[
+					SNew(STextBlock)
+					.Text(this, &SNeatMetadataBulkEditor::GetCollectionText)
+				]
+			]
+			+SHorizontalBox::Slot()
+			.FillWidth(1.0f)
+			.Padding(0.0f, 0.0f, 4.0f, 0.0f)
+			[
+				SNew(SSearchBox)
+				.HintText(INVTEXT("Search Blueprints, variables and types"))
+				.OnTextChanged(this, &SNeatMetadataBulkEditor::OnSearchTextChanged)
+			]
+			+SHorizontalBox::Slot()
+			.AutoWidth()
+			.VAlign(VAlign_Center)
+			.Padding(0.0f, 0.0f, 4.0f, 0.0f)
+			[
+				SNew(SCheckBox)
+				.IsChecked_Lambda([this]() { return bOnlyUsedByCollection ? ECheckBoxState::Checked : ECheckBoxState::Unchecked; })
+				.OnCheckStateChanged_Lambda([this](ECheckBoxState InState) { bOnlyUsedByCollection = InState == ECheckBoxState::Checked; RefreshFilter(); })
+				[
+					SNew(STextBlock)
+					.Text(INVTEXT("Only Variables Using Collection"))
+				]
+			]
+			+SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(0.0f, 0.0f, 4.0f, 0.0f)
+			[
+				SNew(SButton)
+				.Text(INVTEXT("Refresh"))
+				.IsEnabled_Lambda([this]() { return NumPendingValues == 0; })
+				.OnClicked_Lambda([this]() { RefreshRows(); return FReply::Handled(); })
+			]
+			+SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(0.0f, 0.0f, 4.0f, 0.0f)
+			[
+				SNew(SButton)
+				.Text(INVTEXT("Discard"))
+				.IsEnabled_Lambda([this]() { return NumPendingValues > 0; })
+				.OnClicked(this, &SNeatMetadataBulkEditor::OnDiscardClicked)
+			]
+			+SHorizontalBox::Slot()
+			.AutoWidth()
+			[
+				SNew(SButton)
+				.Text(this, &SNeatMetadataBulkEditor::GetApplyText)
+				.IsEnabled_Lambda([this]() { return NumPendingValues > 0; })
+				.OnClicked(this, &SNeatMetadataBulkEditor::OnApplyClicked)
+			]
+		]
+		+SVerticalBox::Slot()
+		.FillHeight(1.0f)
+		[
+			SAssignNew(ListView, SListView<FNeatMetadataBulkEditorRowPtr>)
+			.ListItemsSource(&FilteredRows)
+			.SelectionMode(ESelectionMode::Multi)
+			.OnGenerateRow(this, &SNeatMetadataBulkEditor::OnGenerateRow)
+			.OnContextMenuOpening(this, &SNeatMetadataBulkEditor::OnContextMenuOpening)
+			.HeaderRow(SAssignNew(HeaderRow, SHeaderRow))
+		]
+		+SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(4.0f)
+		[
+			SNew(STextBlock)
+			.Text(this, &SNeatMetadataBulkEditor::GetStatusText)
+			.ColorAndOpacity(FSlateColor::UseSubduedForeground())
+		]
+	];
+
+	RefreshColumns();
+	RefreshRows();
+}
+
+void SNeatMetadataBulkEditor::RefreshRows()
+{
+	Rows.Reset();
+	NumBlueprints = 0;
+	NumUntaggedBlueprints = 0;
+	NumPendingValues = 0;
+
+	FARFilter Filter;
+	Filter.ClassPaths.Add(UBlueprint::StaticClass()->GetClassPathName());
+	Filter.bRecursiveClasses = true;
+
+	const IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(AssetRegistryConstants::ModuleName).Get();
+	TArray<FNeatMetadataVariableSummary> Variables;
+	AssetRegistry.EnumerateAssets(Filter, [&](const FAssetData& AssetData)
+	{
+		// Loaded Blueprints may have changes that haven't been saved to the tag yet. Nothing is loaded here.
+		Variables.Reset();
+		if (const UBlueprint* LoadedBlueprint = Cast<UBlueprint>(AssetData.FastGetAsset(false)))
+		{
+			FNeatMetadataAssetTags::Summarize(*LoadedBlueprint, Variables);
+		}
+		else if (!FNeatMetadataAssetTags::IsTagged(AssetData))
+		{
+			NumUntaggedBlueprints++;
+			return true;
+		}
+		else if (!FNeatMetadataAssetTags::GetSummary(AssetData, Variables))
+		{
+			return true;
+		}
+
+		NumBlueprints++;
+		const FSoftObjectPath BlueprintPath = AssetData.GetSoftObjectPath();
+		const FString BlueprintName = AssetData.AssetName.ToString();
+		for (FNeatMetadataVariableSummary& Variable : Variables)
+		{
+			FNeatMetadataBulkEditorRowPtr Row = MakeShared<FNeatMetadataBulkEditorRow>();
+			Row->Blueprint = BlueprintPath;
+			Row->BlueprintName = BlueprintName;
+			Row->Variable = MoveTemp(Variable);
+			Rows.Add(MoveTemp(Row));
+		}
+		return true;
+	});
+
+	Rows.Sort([](const FNeatMetadataBulkEditorRowPtr& A, const FNeatMetadataBulkEditorRowPtr& B)
+	{
+		const int32 Compare = A->BlueprintName.Compare(B->BlueprintName, ESearchCase::IgnoreCase);
+		return Compare != 0 ? Compare < 0 : A->Variable.Variable.LexicalLess(B->Variable.Variable);
+	});
+
+	RefreshFilter();
+}
+
+void SNeatMetadataBulkEditor::RefreshFilter()
+{
+	FilteredRows.Reset();
+	for (const FNeatMetadataBulkEditorRowPtr& Row : Rows)
+	{
+		if (!SearchText.IsEmpty()
+			&& !Row->BlueprintName.Contains(SearchText)
+			&& !Row->Variable.Variable.ToString().Contains(SearchText)
+			&& !Row->Variable.Type.Contains(SearchText))
+		{
+			continue;
+		}
+
+		if (bOnlyUsedByCollection && !Algo::AnyOf(PropertyColumns, [&](FName PropertyName) { return Row->Variable.Find(PropertyName) || Row->PendingValues.Contains(PropertyName); }))
+		{
+			continue;
+		}
+
+		FilteredRows.Add(Row);
+	}
+
+	ListView->RequestListRefresh();
+}
+
+void SNeatMetadataBulkEditor::RefreshColumns()
+{
+	HeaderRow->ClearColumns();
+	HeaderRow->AddColumn(SHeaderRow::Column(BlueprintColumn).DefaultLabel(INVTEXT("Blueprint")).FillWidth(1.0f));
+	HeaderRow->AddColumn(SHeaderRow::Column(VariableColumn).DefaultLabel(INVTEXT("Variable")).FillWidth(1.0f));
+	HeaderRow->AddColumn(SHeaderRow::Column(TypeColumn).DefaultLabel(INVTEXT("Type")).FillWidth(0.75f));
+
+	PropertyColumns.Reset();
+	if (UClass* Class = SelectedCollection.Get())
+	{
+		for (const FNeatMetadataCollectionLayout::FEntry& Entry : FNeatMetadataCollectionLayout::Get(*Class).GetEntries())
+		{
+			// Properties that are only visible for some variables are still listed. Visibility is checked when values are applied.
+			if (!Entry.bStaticallyVisible && !Entry.bDynamicVisibility)
+			{
+				continue;
+			}
+
+			// Columns are named after the metadata key of their property, which is also what the summary is keyed by.
+			PropertyColumns.Add(Entry.Name);
+			HeaderRow->AddColumn(SHeaderRow::Column(Entry.Name)
+				.DefaultLabel(Entry.Property->GetDisplayNameText())
+				.DefaultTooltip(Entry.Property->GetToolTipText())
+				.FillWidth(1.0f));
+		}
+	}
+
+	// Rows generate one widget per column, so they have to be regenerated.
+	ListView->RebuildList();
+}
+
+TSharedRef<ITableRow> SNeatMetadataBulkEditor::OnGenerateRow(FNeatMetadataBulkEditorRowPtr InRow, const TSharedRef<STableViewBase>& InOwnerTable)
+{
+	return SNew(SNeatMetadataBulkEditorTableRow, InOwnerTable, InRow, this);
+}
+
+TSharedPtr<SWidget> SNeatMetadataBulkEditor::OnContextMenuOpening()
+{
+	// Right-clicking a selected row keeps the selection, unlike clicking a cell to edit it.
+	const TArray<FNeatMetadataBulkEditorRowPtr> SelectedRows = ListView->GetSelectedItems();
+	const UClass* Class = SelectedCollection.Get();
+	if (SelectedRows.IsEmpty() || !Class || PropertyColumns.IsEmpty())
+	{
+		return nullptr;
+	}
+
+	FMenuBuilder MenuBuilder(true, nullptr);
+	MenuBuilder.BeginSection(NAME_None, FText::Format(INVTEXT("Set on {0} Selected {0}|plural(one=Variable,other=Variables)"), SelectedRows.Num()));
+	for (const FName PropertyName : PropertyColumns)
+	{
+		// Start from the value of the selected rows, if they all have the same one.
+		const FString FirstValue = GetCellValue(*SelectedRows[0], PropertyName);
+		const bool bIsMixed = Algo::AnyOf(SelectedRows, [&](const FNeatMetadataBulkEditorRowPtr& Row) { return GetCellValue(*Row, PropertyName) != FirstValue; });
+
+		const FProperty* Property = FindFProperty<FProperty>(Class, PropertyName);
+		MenuBuilder.AddWidget(
+			SNew(SBox)
+			.MinDesiredWidth(200.0f)
+			[
+				SNew(SEditableTextBox)
+				.Text(bIsMixed ? FText() : FText::FromString(FirstValue))
+				.HintText(bIsMixed ? INVTEXT("Multiple Values") : FText())
+				.ToolTipText(INVTEXT("Press Enter to set this value on all selected variables. An empty value resets them to the default."))
+				.SelectAllTextWhenFocused(true)
+				.OnTextCommitted_Lambda([this, PropertyName](const FText& InText, ETextCommit::Type InCommitType)
+				{
+					if (InCommitType == ETextCommit::OnEnter)
+					{
+						SetSelectedValue(PropertyName, InText.ToString());
+						FSlateApplication::Get().DismissAllMenus();
+					}
+				})
+			],
+			Property ? Property->GetDisplayNameText() : FText::FromName(PropertyName));
+	}
+	MenuBuilder.EndSection();
+
+	return MenuBuilder.MakeWidget();
+}
+
+TSharedRef<SWidget> SNeatMetadataBulkEditor::OnGenerateCollectionWidget(TWeakObjectPtr<UClass> InClass) const
+{
+	return SNew(STextBlock)
+		.Text(InClass.IsValid() ? InClass->GetDisplayNameText() : FText::GetEmpty());
+}
+
+void SNeatMetadataBulkEditor::OnCollectionChanged(TWeakObjectPtr<UClass> InClass, ESelectInfo::Type InSelectInfo)
+{
+	SelectedCollection = InClass;
+	RefreshColumns();
+	RefreshFilter();
+}
+
+void SNeatMetadataBulkEditor::OnSearchTextChanged(const FText& InText)
+{
+	SearchText = InText.ToString();
+	RefreshFilter();
+}
+
+FReply SNeatMetadataBulkEditor::OnApplyClicked()
+{
+	UClass* CollectionClass = SelectedCollection.Get();
+	if (!CollectionClass)
+	{
+		return FReply::Handled();
+	}
+
+	TMap<FSoftObjectPath, TArray<FNeatMetadataBulkEditorRowPtr>> RowsByBlueprint;
+	for (const FNeatMetadataBulkEditorRowPtr& Row : Rows)
+	{
+		if (!Row->PendingValues.IsEmpty())
+		{
+			RowsByBlueprint.FindOrAdd(Row->Blueprint).Add(Row);
+		}
+	}
+
+	const TStrongObjectPtr<UNeatMetadataCollection> Collection(NewObject<UNeatMetadataCollection>(GetTransientPackage(), CollectionClass));
+	const FNeatMetadataCollectionLayout& Layout = FNeatMetadataCollectionLayout::Get(*CollectionClass);
+	int32 NumApplied = 0;
+	int32 NumFailed = 0;
+	int32 NumChangedBlueprints = 0;
+	{
+		const FScopedTransaction Transaction(INVTEXT("Bulk Edit Metadata"));
+		for (const TPair<FSoftObjectPath, TArray<FNeatMetadataBulkEditorRowPtr>>& BlueprintRows : RowsByBlueprint)
+		{
+			// Only Blueprints that have edits are loaded.
+			UBlueprint* Blueprint = Cast<UBlueprint>(BlueprintRows.Key.TryLoad());
+			const UClass* VariableClass = Blueprint ? (Blueprint->SkeletonGeneratedClass ? Blueprint->SkeletonGeneratedClass : Blueprint->GeneratedClass) : nullptr;
+			if (!VariableClass)
+			{
+				UE_LOG(LogNeatMetadata, Warning, TEXT("Couldn't load %s."), *BlueprintRows.Key.ToString());
+				for (const FNeatMetadataBulkEditorRowPtr& Row : BlueprintRows.Value)
+				{
+					NumFailed += Row->PendingValues.Num();
+				}
+				continue;
+			}
+
+			{
+				// All values of a Blueprint are written together, and recorded as a single undo entry.
+				FNeatMetadataBatch Batch;
+				for (const FNeatMetadataBulkEditorRowPtr& Row : BlueprintRows.Value)
+				{
+					FProperty* Property = FindFProperty<FProperty>(VariableClass, Row->Variable.Variable);
+					if (!Property || !Collection->IsRelevantForProperty(*Property))
+					{
+						UE_LOG(LogNeatMetadata, Warning, TEXT("%s.%s: %s doesn't apply to this variable."), *Row->BlueprintName, *Row->Variable.Variable.ToString(), *CollectionClass->GetName());
+						NumFailed += Row->PendingValues.Num();
+						continue;
+					}
+
+					Collection->InitializeFromMetadata(FNeatMetadataWrapper(Property, Blueprint));
+
+					// Values are applied in field order, like when they are imported, since a property may be hidden by the
+					// value of one declared before it. Hidden properties aren't written, just like in the details panel.
+					for (const FNeatMetadataCollectionLayout::FEntry& Entry : Layout.GetEntries())
+					{
+						const FString* Value = Row->PendingValues.Find(Entry.Name);
+						if (!Value)
+						{
+							continue;
+						}
+
+						if (!FNeatMetadataCollectionLayout::IsVisible(*Collection, Entry))
+						{
+							UE_LOG(LogNeatMetadata, Warning, TEXT("%s.%s: %s isn't visible for this variable."), *Row->BlueprintName, *Row->Variable.Variable.ToString(), *Entry.Name.ToString());
+							NumFailed++;
+							continue;
+						}
+
+						const FString Text = Value->IsEmpty() ? GetDefaultValue(*CollectionClass, Entry.Name) : *Value;
+						if (Collection->ApplyValue(Entry.Name, Text))
+						{
+							NumApplied++;
+						}
+						else
+						{
+							UE_LOG(LogNeatMetadata, Warning, TEXT("%s.%s: Couldn't set %s to '%s'."), *Row->BlueprintName, *Row->Variable.Variable.ToString(), *Entry.Name.ToString(), **Value);
+							NumFailed++;
+						}
+					}
+				}
+			}
+			NumChangedBlueprints++;
+
+			// Show what was actually written, which may differ from what was typed.
+			TArray<FNeatMetadataVariableSummary> Variables;
+			FNeatMetadataAssetTags::Summarize(*Blueprint, Variables);
+			for (const FNeatMetadataBulkEditorRowPtr& Row : BlueprintRows.Value)
+			{
+				if (FNeatMetadataVariableSummary* Variable = Variables.FindByPredicate([&](const FNeatMetadataVariableSummary& Summary) { return Summary.Variable == Row->Variable.Variable; }))
+				{
+					Row->Variable = MoveTemp(*Variable);
+				}
+			}
+		}
+	}
+
+	for (const TPair<FSoftObjectPath, TArray<FNeatMetadataBulkEditorRowPtr>>& BlueprintRows : RowsByBlueprint)
+	{
+		for (const FNeatMetadataBulkEditorRowPtr& Row : BlueprintRows.Value)
+		{
+			Row->PendingValues.Reset();
+		}
+	}
+	NumPendingValues = 0;
+
+	LastResult = NumFailed > 0
+		? FText::Format(INVTEXT("Applied {0} values in {1} Blueprints. {2} values couldn't be applied, see the output log."), NumApplied, NumChangedBlueprints, NumFailed)
+		: FText::Format(INVTEXT("Applied {0} values in {1} Blueprints."), NumApplied, NumChangedBlueprints);
+
+	RefreshFilter();
+	return FReply::Handled();
+}
+
+FReply SNeatMetadataBulkEditor::OnDiscardClicked()
+{
+	for (const FNeatMetadataBulkEditorRowPtr& Row : Rows)
+	{
+		Row->PendingValues.Reset();
+	}
+	NumPendingValues = 0;
+
+	// Rows may only have been listed because of their pending values.
+	RefreshFilter();
+	return FReply::Handled();
+}
+
+FText SNeatMetadataBulkEditor::GetCollectionText() const
+{
+	return SelectedCollection.IsValid() ? SelectedCollection->GetDisplayNameText() : INVTEXT("Select a Collection");
+}
+
+FText SNeatMetadataBulkEditor::GetApplyText() const
+{
+	return NumPendingValues > 0 ? FText::Format(INVTEXT("Apply {0} {0}|plural(one=Change,other=Changes)"), NumPendingValues) : INVTEXT("Apply");
+}
+
+FText SNeatMetadataBulkEditor::GetStatusText() const
+{
+	FText Summary = FText::Format(INVTEXT("Showing {0} of {1} variables in {2} Blueprints."), FilteredRows.Num(), Rows.Num(), NumBlueprints);
+	if (NumUntaggedBlueprints > 0)
+	{
+		Summary = FText::Format(INVTEXT("{0} {1} {1}|plural(one=Blueprint isn't,other=Blueprints aren't) listed, since they haven't been saved with the plugin enabled. Resave them with -run=NeatMetadata -ResaveUntagged."),
+			Summary, NumUntaggedBlueprints);
+	}
+	return LastResult.IsEmpty() ? Summary : FText::Format(INVTEXT("{0} {1}"), LastResult, Summary);
+}
+
+FString SNeatMetadataBulkEditor::GetCellValue(const FNeatMetadataBulkEditorRow& InRow, FName InPropertyName) const
+{
+	if (const FString* Pending = InRow.PendingValues.Find(InPropertyName))
+	{
+		return *Pending;
+	}
+
+	const FString* Value = InRow.Variable.Find(InPropertyName);
+	return Value ? *Value : FString();
+}
+
+bool SNeatMetadataBulkEditor::IsCellPending(const FNeatMetadataBulkEditorRow& InRow, FName InPropertyName) const
+{
+	return InRow.PendingValues.Contains(InPropertyName);
+}
+
+void SNeatMetadataBulkEditor::SetCellValue(const FNeatMetadataBulkEditorRowPtr& InRow, FName InPropertyName, const FString& InValue)
+{
+	const FString* Current = InRow->Variable.Find(InPropertyName);
+	if ((Current ? *Current : FString()) == InValue)
+	{
+		NumPendingValues -= InRow->PendingValues.Remove(InPropertyName);
+	}
+	else
+	{
+		NumPendingValues += InRow->PendingValues.Contains(InPropertyName) ? 0 : 1;
+		InRow->PendingValues.Add(InPropertyName, InValue);
+	}
+}
+
+void SNeatMetadataBulkEditor::SetSelectedValue(FName InPropertyName, const FString& InValue)
+{
+	for (const FNeatMetadataBulkEditorRowPtr& Row : ListView->GetSelectedItems())
+	{
+		SetCellValue(Row, InPropertyName, InValue);
+	}
+}
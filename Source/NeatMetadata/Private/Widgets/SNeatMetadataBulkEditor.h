@@ -0,0 +1,76 @@
+﻿// Copyright Viktor Pramberg. All Rights Reserved.
+#pragma once
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/DeclarativeSyntaxSupport.h"
+#include "Widgets/Views/SListView.h"
+#include "Internationalization/Text.h"
+
+class SHeaderRow;
+
+// FNeatMetadataBulkEditorRow is in the cpp file.
+using FNeatMetadataBulkEditorRowPtr = TSharedPtr<struct FNeatMetadataBulkEditorRow>;
+
+/**
+ * Editor tab that lists the variables of all Blueprints, with one column per property of a metadata collection. Rows are
+ * built from the asset registry tags written by FNeatMetadataAssetTags, so nothing is loaded until a value is applied.
+ *
+ * Edits are queued, and applied together: each Blueprint that has edits is loaded and written to through a single batch.
+ * A value can be set on all selected rows at once from the context menu of the list, since clicking a cell to edit it
+ * changes the selection to that row.
+ */
+class SNeatMetadataBulkEditor : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SNeatMetadataBulkEditor) {}
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+	static const FName TabName;
+	static void RegisterTabSpawner();
+	static void UnregisterTabSpawner();
+
+protected:
+	void RefreshRows();
+	void RefreshFilter();
+	void RefreshColumns();
+
+	TSharedRef<ITableRow> OnGenerateRow(FNeatMetadataBulkEditorRowPtr InRow, const TSharedRef<STableViewBase>& InOwnerTable);
+	TSharedPtr<SWidget> OnContextMenuOpening();
+	TSharedRef<SWidget> OnGenerateCollectionWidget(TWeakObjectPtr<UClass> InClass) const;
+	void OnCollectionChanged(TWeakObjectPtr<UClass> InClass, ESelectInfo::Type InSelectInfo);
+	void OnSearchTextChanged(const FText& InText);
+
+	FReply OnApplyClicked();
+	FReply OnDiscardClicked();
+	FText GetCollectionText() const;
+	FText GetApplyText() const;
+	FText GetStatusText() const;
+
+	FString GetCellValue(const FNeatMetadataBulkEditorRow& InRow, FName InPropertyName) const;
+	bool IsCellPending(const FNeatMetadataBulkEditorRow& InRow, FName InPropertyName) const;
+	void SetCellValue(const FNeatMetadataBulkEditorRowPtr& InRow, FName InPropertyName, const FString& InValue);
+	void SetSelectedValue(FName InPropertyName, const FString& InValue);
+
+private:
+	TSharedPtr<SHeaderRow> HeaderRow;
+	TSharedPtr<SListView<FNeatMetadataBulkEditorRowPtr>> ListView;
+
+	TArray<FNeatMetadataBulkEditorRowPtr> Rows;
+	TArray<FNeatMetadataBulkEditorRowPtr> FilteredRows;
+	int32 NumBlueprints = 0;
+	// Blueprints that aren't loaded and were saved before the plugin was enabled, so they can't be listed.
+	int32 NumUntaggedBlueprints = 0;
+
+	TArray<TWeakObjectPtr<UClass>> Collections;
+	TWeakObjectPtr<UClass> SelectedCollection;
+	// Property names of the selected collection, one column each. Also the metadata keys the properties are stored under.
+	TArray<FName> PropertyColumns;
+
+	FString SearchText;
+	bool bOnlyUsedByCollection = false;
+	int32 NumPendingValues = 0;
+	FText LastResult;
+
+	friend class SNeatMetadataBulkEditorTableRow;
+};
@@ -0,0 +1,98 @@
+﻿// Copyright Viktor Pramberg. All Rights Reserved.
+#include "SNeatRowTypeSelector.h"
+#include "NeatRowStructCatalog.h"
+
+#include "DetailLayoutBuilder.h"
+
+struct FNeatRowTypeSelectorItem
+{
+	// Empty for the "None" item.
+	FString Path;
+	FText DisplayName;
+	int32 NumDataTables = 0;
+};
+
+void SNeatRowTypeSelector::Construct(const FArguments&, TSharedRef<IPropertyHandle> InPropertyHandle)
+{
+	PropertyHandle = InPropertyHandle;
+
+	ChildSlot
+	[
+		SNew(SNeatCatalogSelector<FNeatRowTypeSelectorItem>)
+		.MenuWidth(300.0f)
+		.Generation_Lambda([]() { return FNeatRowStructCatalog::Get().GetGeneration(); })
+		.OnRefreshItems(this, &SNeatRowTypeSelector::OnRefreshItems)
+		.OnGenerateItem(this, &SNeatRowTypeSelector::OnGenerateItem)
+		.OnItemPicked(this, &SNeatRowTypeSelector::OnItemPicked)
+		.ButtonContent()
+		[
+			SNew(STextBlock)
+			.Text(this, &SNeatRowTypeSelector::GetButtonText)
+			.Font(IDetailLayoutBuilder::GetDetailFont())
+		]
+	];
+}
+
+void SNeatRowTypeSelector::OnRefreshItems(TArray<FNeatRowTypeSelectorItemPtr>& OutItems, FNeatSearchIndex& OutSearchIndex) const
+{
+	const TConstArrayView<FNeatRowStructCatalog::FEntry> Entries = FNeatRowStructCatalog::Get().GetEntries();
+	OutItems.Reserve(Entries.Num() + 1);
+	OutItems.Add(MakeShared<FNeatRowTypeSelectorItem>(FNeatRowTypeSelectorItem{ FString(), INVTEXT("None") }));
+	for (const FNeatRowStructCatalog::FEntry& Entry : Entries)
+	{
+		OutItems.Add(MakeShared<FNeatRowTypeSelectorItem>(FNeatRowTypeSelectorItem{ Entry.Path, Entry.DisplayName, Entry.NumDataTables }));
+	}
+
+	for (const FNeatRowTypeSelectorItemPtr& Item : OutItems)
+	{
+		OutSearchIndex.Add(Item->DisplayName.ToString(), FString(), Item->Path);
+	}
+}
+
+TSharedRef<SWidget> SNeatRowTypeSelector::OnGenerateItem(FNeatRowTypeSelectorItemPtr InItem, const TAttribute<FText>& InHighlightText) const
+{
+	const bool bIsNone = InItem->Path.IsEmpty();
+	
+	return SNew(SHorizontalBox)
+		.ToolTipText(FText::FromString(InItem->Path))
+		+SHorizontalBox::Slot()
+		.FillWidth(1.0f)
+		.VAlign(VAlign_Center)
+		.Padding(0.0f, 3.0f, 6.0f, 3.0f)
+		[
+			SNew(STextBlock)
+			.Text(InItem->DisplayName)
+			.HighlightText(InHighlightText)
+			.Font(IDetailLayoutBuilder::GetDetailFont())
+		]
+		+SHorizontalBox::Slot()
+		.AutoWidth()
+		.VAlign(VAlign_Center)
+		.Padding(6.0f, 3.0f, 0.0f, 3.0f)
+		[
+			SNew(STextBlock)
+			.Visibility(bIsNone ? EVisibility::Collapsed : EVisibility::Visible)
+			.Text(FText::AsNumber(InItem->NumDataTables))
+			.ToolTipText(FText::Format(INVTEXT("Used by {0} {0}|plural(one=DataTable,other=DataTables)."), InItem->NumDataTables))
+			.ColorAndOpacity(FSlateColor::UseSubduedForeground())
+			.Font(IDetailLayoutBuilder::GetDetailFontItalic())
+		];
+}
+
+void SNeatRowTypeSelector::OnItemPicked(FNeatRowTypeSelectorItemPtr InItem) const
+{
+	PropertyHandle->SetValue(InItem->Path);
+}
+
+FText SNeatRowTypeSelector::GetButtonText() const
+{
+	FString Value;
+	PropertyHandle->GetValue(Value);
+	if (Value.IsEmpty() || Value == TEXT("None"))
+	{
+		return INVTEXT("None");
+	}
+
+	// Only show the name of the struct, the full path is in the tooltip of each entry.
+	return FText::FromString(FPackageName::ObjectPathToObjectName(Value));
+}
@@ -0,0 +1,29 @@
+﻿// Copyright Viktor Pramberg. All Rights Reserved.
+#pragma once
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/DeclarativeSyntaxSupport.h"
+#include "Internationalization/Text.h"
+#include "SNeatCatalogSelector.h"
+
+class IPropertyHandle;
+
+// FNeatRowTypeSelectorItem is in the cpp file.
+using FNeatRowTypeSelectorItemPtr = TSharedPtr<struct FNeatRowTypeSelectorItem>;
+
+// Widget that displays all structs that can be used as DataTable rows, and how many DataTables use each of them.
+class SNeatRowTypeSelector : public SCompoundWidget
+{
+	SLATE_BEGIN_ARGS(SNeatRowTypeSelector) {}
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments&, TSharedRef<IPropertyHandle> InPropertyHandle);
+
+protected:
+	void OnRefreshItems(TArray<FNeatRowTypeSelectorItemPtr>& OutItems, FNeatSearchIndex& OutSearchIndex) const;
+	TSharedRef<SWidget> OnGenerateItem(FNeatRowTypeSelectorItemPtr InItem, const TAttribute<FText>& InHighlightText) const;
+	void OnItemPicked(FNeatRowTypeSelectorItemPtr InItem) const;
+	FText GetButtonText() const;
+
+private:
+	TSharedPtr<IPropertyHandle> PropertyHandle;
+};
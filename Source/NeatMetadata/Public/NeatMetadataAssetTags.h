@@ -0,0 +1,101 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UBlueprint;
+struct FAssetData;
+struct FEdGraphPinType;
+
+/** The metadata of a single Blueprint variable, as stored in the asset registry. */
+struct FNeatMetadataVariableSummary
+{
+	FName Variable;
+	// A short description of the variable's type, e.g. `real` or `Array<object(Texture2D)>`. Empty for tags written by older versions.
+	FString Type;
+	// Only keys that are managed by a metadata collection, in the order they are stored on the variable.
+	TArray<TPair<FName, FString>> Metadata;
+
+	/** @return The value for the key, or nullptr if the variable doesn't have it. */
+	const FString* Find(FName InKey) const
+	{
+		const TPair<FName, FString>* Found = Metadata.FindByPredicate([InKey](const TPair<FName, FString>& Pair) { return Pair.Key == InKey; });
+		return Found ? &Found->Value : nullptr;
+	}
+};
+
+/**
+ * Publishes a summary of the metadata on Blueprint variables as an asset registry tag, written whenever a Blueprint is
+ * saved. Metadata can then be queried across the project without loading any Blueprints, e.g. to find all variables
+ * that use a certain GetOptions function.
+ *
+ * Blueprints that haven't been saved since the plugin was enabled don't have the tag yet. They can be resaved with
+ * `-run=NeatMetadata -ResaveUntagged`. @see UNeatMetadataCommandlet.
+ */
+class NEATMETADATA_API FNeatMetadataAssetTags
+{
+public:
+	// Name of the asset registry tag on Blueprint assets.
+	static const FName TagName;
+
+	/** @brief Starts writing the tag for Blueprints that are saved. */
+	static void Register();
+	static void Unregister();
+
+	/**
+	 * @brief Builds the summary of a loaded Blueprint.
+	 * @param InBlueprint The Blueprint to summarize.
+	 * @param OutVariables Receives all variables, with their types and managed metadata.
+	 */
+	static void Summarize(const UBlueprint& InBlueprint, TArray<FNeatMetadataVariableSummary>& OutVariables);
+
+	/**
+	 * @brief Encodes a summary as a compact string. Delimiters in names and values are escaped.
+	 * @param InVariables The summary to encode.
+	 * @return The tag value.
+	 */
+	static FString Encode(TConstArrayView<FNeatMetadataVariableSummary> InVariables);
+
+	/**
+	 * @brief Decodes a tag value that was created by Encode.
+	 * @param InValue The tag value.
+	 * @param OutVariables Receives the decoded variables.
+	 * @return False if the value isn't in a supported format.
+	 */
+	static bool Decode(FStringView InValue, TArray<FNeatMetadataVariableSummary>& OutVariables);
+
+	/**
+	 * @brief Reads and decodes the tag of an asset.
+	 * @return False if the asset doesn't have the tag, or if it couldn't be decoded.
+	 */
+	static bool GetSummary(const FAssetData& InAssetData, TArray<FNeatMetadataVariableSummary>& OutVariables);
+
+	/**
+	 * @brief Has the asset been saved with the tag? Every Blueprint saved with the plugin enabled has it, even if it has no variables.
+	 * @param InAssetData A Blueprint asset.
+	 */
+	static bool IsTagged(const FAssetData& InAssetData);
+
+	using FForEachVariableSignature = void(const FAssetData&, const FNeatMetadataVariableSummary&);
+	/**
+	 * @brief Loops through all variables of tagged Blueprints in the asset registry. Nothing is loaded.
+	 * @param Functor Functor that executes for each variable.
+	 */
+	static void ForEachVariable(TFunctionRef<FForEachVariableSignature> Functor);
+
+	/**
+	 * @brief Is the input key written by any metadata collection?
+	 * @param InKey A metadata key.
+	 */
+	static bool IsManagedKey(FName InKey);
+
+	/**
+	 * @brief Describes a variable type in the format used by FNeatMetadataVariableSummary::Type.
+	 * @param InType The type of a Blueprint variable.
+	 */
+	static FString GetTypeString(const FEdGraphPinType& InType);
+
+private:
+	static FDelegateHandle ExtraObjectTagsHandle;
+};
@@ -0,0 +1,55 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UBlueprint;
+
+/**
+ * Collects metadata writes made through FNeatMetadataWrapper while it is in scope, and flushes them when it goes out of scope.
+ * Each affected variable description is only looked up and updated once, regardless of how many keys were written to it,
+ * and each affected Blueprint gets a single undo record that only contains the metadata that changed.
+ *
+ * Batches may be nested, in which case only the outermost batch flushes. Batches must only be used on the game thread.
+ */
+class NEATMETADATA_API FNeatMetadataBatch : public FNoncopyable
+{
+public:
+	FNeatMetadataBatch();
+	~FNeatMetadataBatch();
+
+	/**
+	 * @brief Queues setting a metadata value on a blueprint variable.
+	 * @param InBlueprint The blueprint that owns the variable.
+	 * @param InVarName The name of the variable.
+	 * @param Key The metadata key.
+	 * @param Value The metadata value.
+	 */
+	void SetMetadata(UBlueprint* InBlueprint, FName InVarName, FName Key, const FString& Value);
+
+	/**
+	 * @brief Queues removing a metadata value from a blueprint variable.
+	 * @param InBlueprint The blueprint that owns the variable.
+	 * @param InVarName The name of the variable.
+	 * @param Key The metadata key.
+	 */
+	void RemoveMetadata(UBlueprint* InBlueprint, FName InVarName, FName Key);
+
+	/**
+	 * @brief Finds a write that hasn't been flushed yet.
+	 * @return Nullptr if there is no pending write for the key. Otherwise the pending value, which is unset if the key is being removed.
+	 */
+	static const TOptional<FString>* FindPending(UBlueprint* InBlueprint, FName InVarName, FName Key);
+
+private:
+	FNeatMetadataBatch& GetOutermost();
+	void Flush();
+
+	using FKeyWrites = TMap<FName, TOptional<FString>>;
+	using FVariableWrites = TMap<FName, FKeyWrites>;
+	TMap<TWeakObjectPtr<UBlueprint>, FVariableWrites> PendingWrites;
+
+	bool bIsOutermost = false;
+	static FNeatMetadataBatch* Outermost;
+};
@@ -6,6 +6,27 @@
 #include "NeatMetadataWrapper.h"
 #include "NeatMetadataCollection.generated.h"
 
+/** Problems found while validating the metadata of a single collection. @see UNeatMetadataCollection::ValidateMetadata. */
+struct FNeatMetadataValidationContext
+{
+	/**
+	 * @brief Reports that the metadata is broken.
+	 * @param InMessage A description of the problem, that makes sense without knowing the variable or collection.
+	 */
+	void AddError(FString InMessage) { Errors.Add(MoveTemp(InMessage)); }
+
+	/**
+	 * @brief Reports that the metadata refers to an asset or class that has to exist. References are resolved after
+	 * all variables have been validated, so that they can be checked in bulk.
+	 * @param InPath The path that should be possible to resolve.
+	 * @param InDescription What the path is used for, displayed if it can't be resolved.
+	 */
+	void AddAssetReference(const FSoftObjectPath& InPath, FString InDescription) { AssetReferences.Emplace(InPath, MoveTemp(InDescription)); }
+
+	TArray<FString> Errors;
+	TArray<TPair<FSoftObjectPath, FString>> AssetReferences;
+};
+
 /**
  * Encapsulates a collection of metadata for some blueprint variable. UPROPERTIES in this class that are visible in
  * the editor (i.e. EditAnywhere) will show up in the details panel of all selected variables that matches its conditions.
@@ -48,6 +69,28 @@ public:
 	 */
 	virtual TSharedPtr<SWidget> CreateValueWidgetForProperty(const TSharedRef<IPropertyHandle>& InHandle);
 
+	/**
+	 * @brief May return a widget that is displayed below the properties of this collection.
+	 * @return A widget or a nullptr if nothing should be displayed.
+	 */
+	virtual TSharedPtr<SWidget> CreateFooterWidget();
+
+	/**
+	 * @brief Sets a property on this object from text, and stores it as metadata on the variable that this object was
+	 * initialized from. The metadata is written exactly like when the property is edited in the details panel.
+	 * @param InPropertyName The name of the property on this object.
+	 * @param InValue The value, in the same format as the text that is copied from a property in the editor.
+	 * @return False if there is no such property, if the value couldn't be parsed, or if the object isn't initialized.
+	 */
+	bool ApplyValue(FName InPropertyName, const FString& InValue);
+
+	/**
+	 * @brief Checks that the metadata this object was initialized from still makes sense, e.g. that referenced
+	 * functions and properties exist. Used when linting metadata, without displaying anything.
+	 * @param Context Receives any problems that were found.
+	 */
+	virtual void ValidateMetadata(FNeatMetadataValidationContext& Context) const;
+
 protected:
 	/**
 	 * @brief Is this collection relevant for the potentially *contained* input property.
@@ -58,10 +101,21 @@ protected:
 
 	/**
 	 * @brief Should the input property be visible in the UI?
+	 * Only called on the CDO, once per class, unless IsPropertyVisibilityDynamic returns true for the property. Overrides
+	 * that depend on the variable being customized, or on other values of this object, must override that as well.
 	 * @param Property The property to test. This is a member property of this object.
 	 * @return True if it is visible.
 	 */
 	virtual bool IsPropertyVisible(const FProperty& Property) const;
+
+	/**
+	 * @brief Does the visibility of the input property depend on the property being customized, or on other values of this object?
+	 * Visibility of other properties is only evaluated once per class, on the CDO. Override this for every property that
+	 * IsPropertyVisible has special handling for.
+	 * @param Property The property to test. This is a member property of this object.
+	 * @return True if visibility has to be evaluated for each selection.
+	 */
+	virtual bool IsPropertyVisibilityDynamic(const FProperty& Property) const;
 	
 	/**
 	 * @brief Retrieves the value for the input property so that it can be stored as metadata.
@@ -83,11 +137,19 @@ protected:
 	 */
 	void InitializeValueForProperty(const FProperty& Property);
 
+	/**
+	 * @brief Exports the value of a property, and stores it as metadata on the current variable.
+	 * @param Property The property on this object to export.
+	 */
+	void WriteMetadataForProperty(FProperty& Property);
+
 protected:
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
 
 protected:
 	FNeatMetadataWrapper CurrentWrapper;
+
+	friend class FNeatMetadataCollectionLayout;
 };
 
 
@@ -4,8 +4,14 @@
 
 #include "CoreMinimal.h"
 #include "IDetailCustomization.h"
+#include "Containers/Ticker.h"
 
 class IBlueprintEditor;
+class IDetailCategoryBuilder;
+class IDetailGroup;
+class IPropertyUtilities;
+class UNeatMetadataCollection;
+class FNeatMetadataWrapper;
 
 /**
  * 
@@ -15,9 +21,38 @@ class FNeatMetadataDetailCustomization : public IDetailCustomization
 public:
 	static TSharedPtr<IDetailCustomization> MakeInstance(TSharedPtr<IBlueprintEditor> InBlueprintEditor);
 	FNeatMetadataDetailCustomization(UBlueprint* InBlueprint);
+	virtual ~FNeatMetadataDetailCustomization() override;
 
 	virtual void CustomizeDetails(IDetailLayoutBuilder& DetailLayout) override;
 	
 private:
+	/**
+	 * @brief Imports the metadata into a collection and adds rows for all of its visible properties.
+	 * @param Category The metadata category.
+	 * @param Group The group to add rows to, or nullptr to add them to the category directly.
+	 * @param Collection The collection to add.
+	 * @param MetaWrapper The metadata of the variable being customized.
+	 */
+	void AddCollectionRows(IDetailCategoryBuilder& Category, IDetailGroup* Group, UNeatMetadataCollection& Collection, const FNeatMetadataWrapper& MetaWrapper) const;
+
+	/**
+	 * @brief Remembers when groups are expanded or collapsed, and refreshes the details panel when a group that hasn't
+	 * been populated is expanded.
+	 * @return False once the details panel has been refreshed, since that destroys this customization.
+	 */
+	bool TickGroupExpansion(float DeltaTime);
+	
 	TWeakObjectPtr<UBlueprint> Blueprint;
-};
\ No newline at end of file
+
+	struct FTrackedGroup
+	{
+		// Owned by the layout, which is destroyed together with this customization.
+		IDetailGroup* Group = nullptr;
+		FName Name;
+		bool bPopulated = false;
+		bool bWasExpanded = false;
+	};
+	TArray<FTrackedGroup> TrackedGroups;
+	TWeakPtr<IPropertyUtilities> PropertyUtilities;
+	FTSTicker::FDelegateHandle ExpansionTickerHandle;
+};
@@ -7,6 +7,7 @@
 #include "NeatMetadataSettings.generated.h"
 
 class UNeatMetadataCollection;
+class FNeatMetadataRelevanceCache;
 
 /**
  * Project-wide settings for the Neat Metadata plugin. Configures what metadata that should be visible.
@@ -22,12 +23,21 @@ public:
 	using FForEachCollectionSignature = void(UNeatMetadataCollection&);
 	void ForEachCollection(TFunctionRef<FForEachCollectionSignature> Functor) const;
 
+	/**
+	 * @brief Loops through all collections that are relevant for the input property, in display order.
+	 * The result is cached per property type, so IsRelevantForProperty is only evaluated once for each type of variable.
+	 * @param InProperty The property representing the blueprint variable.
+	 * @param Functor Functor that executes for each relevant collection.
+	 */
+	void ForEachRelevantCollection(const FProperty& InProperty, TFunctionRef<FForEachCollectionSignature> Functor) const;
+
 	// Tooltips for groups of metadata.
 	UPROPERTY(Config, EditDefaultsOnly, Category = "Neat Metadata", AdvancedDisplay, meta = (MultiLine = "true"))
 	TMap<FName, FText> GroupTooltips;
 	
 protected:
 	void RebuildMetadataCollections();
+	void ResetRelevanceCache();
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
 	virtual void PostInitProperties() override;
 
@@ -42,6 +52,8 @@ protected:
 	
 	UPROPERTY()
 	TArray<TObjectPtr<UNeatMetadataCollection>> MetadataCollectionInstances;
+
+	TSharedPtr<FNeatMetadataRelevanceCache> RelevanceCache;
 };
 
 /**
@@ -59,4 +71,34 @@ public:
 	// assigned to a property. For regular users this is not necessary and can make it easier to provide invalid values.
 	UPROPERTY(Config, EditDefaultsOnly, DisplayName = "Show \"All Metadata\" Category", Category = "Neat Metadata")
 	bool bShowAllMetadataCategory = false;
+
+	// Whether to run the selected GetOptions function and show a preview of the options it returns.
+	UPROPERTY(Config, EditDefaultsOnly, DisplayName = "Preview GetOptions", Category = "Neat Metadata|GetOptions")
+	bool bPreviewGetOptions = true;
+
+	// GetOptions functions that take longer than this to evaluate are not evaluated again until they are changed.
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Neat Metadata|GetOptions", meta = (EditCondition = "bPreviewGetOptions", Units = "Milliseconds", ClampMin = "1"))
+	float GetOptionsPreviewBudget = 50.0f;
+
+	// The number of options to list in the GetOptions preview.
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Neat Metadata|GetOptions", meta = (EditCondition = "bPreviewGetOptions", ClampMin = "0"))
+	int32 GetOptionsPreviewCount = 5;
+
+	/**
+	 * @brief Was the metadata group expanded the last time it was shown?
+	 * @param InGroupName The name of the group.
+	 */
+	bool IsGroupExpanded(FName InGroupName) const;
+
+	/**
+	 * @brief Stores the expansion state of a metadata group, so that it is remembered between selections and sessions.
+	 * @param InGroupName The name of the group.
+	 * @param bInExpanded Whether the group is expanded.
+	 */
+	void SetGroupExpanded(FName InGroupName, bool bInExpanded);
+
+private:
+	// Metadata groups that are expanded in the details panel. Collapsed groups are only populated once they are expanded.
+	UPROPERTY(Config)
+	TArray<FName> ExpandedGroups;
 };
\ No newline at end of file
@@ -0,0 +1,34 @@
+// Copyright Viktor Pramberg. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UBlueprint;
+struct FBPVariableDescription;
+
+/**
+ * Refers to a variable description in UBlueprint::NewVariables without holding a raw pointer into the array, which would
+ * dangle if the array is reallocated. The cached index is validated against the Blueprint's change generation, and is
+ * looked up again through a per-Blueprint name to index table if it is out of date.
+ */
+class NEATMETADATA_API FNeatMetadataVariableHandle
+{
+public:
+	FNeatMetadataVariableHandle() = default;
+	FNeatMetadataVariableHandle(UBlueprint* InBlueprint, FName InVarName);
+
+	/**
+	 * @brief Resolves the handle.
+	 * @return The variable description, or nullptr if the variable no longer exists.
+	 */
+	FBPVariableDescription* Get() const;
+	bool IsValid() const { return Get() != nullptr; }
+
+private:
+	TWeakObjectPtr<UBlueprint> Blueprint = nullptr;
+	FName VarName;
+
+	mutable int32 CachedIndex = INDEX_NONE;
+	mutable uint32 CachedGeneration = 0;
+};
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "UObject/WeakFieldPtr.h"
+#include "NeatMetadataVariableHandle.h"
 
 /**
  * 
@@ -19,6 +20,13 @@ public:
 	FString GetMetadata(FName Key) const;
 	bool HasMetadata(FName Key) const;
 
+	using FForEachMetadataSignature = void(FName, const FString&);
+	/**
+	 * @brief Loops through all metadata on the variable, without copying the values. Doesn't include unflushed batched writes.
+	 * @param Functor Functor that executes for each key and value.
+	 */
+	void ForEachMetadata(TFunctionRef<FForEachMetadataSignature> Functor) const;
+
 	bool IsValid() const;
 	const FProperty* GetProperty() const; 
 	UBlueprint* GetBlueprint() const;
@@ -26,7 +34,5 @@ public:
 private:
 	TWeakFieldPtr<FProperty> Property = nullptr;
 	TWeakObjectPtr<UBlueprint> Blueprint = nullptr;
-
-	// TODO: Is this valid? What happens if the desc is deleted? Can that even happen while this wrapper is valid?
-	FBPVariableDescription* VariableDesc = nullptr;
+	FNeatMetadataVariableHandle VariableDesc;
 };